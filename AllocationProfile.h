@@ -0,0 +1,72 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "AllocationTracker.h"
+#include "Serializer.h"
+
+namespace BSerializer {
+    /**
+     * @brief The heap activity of each step of a round trip through BSerializer.
+     */
+    struct SerializationAllocations final {
+        /**
+         * @brief The heap activity of BSerializer::SerializedSize.
+         */
+        AllocationCounts serializedSize;
+        /**
+         * @brief The heap activity of BSerializer::Serialize, into a buffer allocated beforehand.
+         */
+        AllocationCounts serialize;
+        /**
+         * @brief The heap activity of BSerializer::Deserialize, including the allocations owned by the deserialized value.
+         */
+        AllocationCounts deserialize;
+    };
+
+    /**
+     * @brief Serializes and deserializes a value, counting the heap allocations of each step on the calling thread.
+     *
+     * For the counts to include allocations through operator new, one translation unit of the program must define BSERIALIZER_DEFINE_ALLOCATION_HOOKS; see BSerializer::AllocationScope.
+     *
+     * Example:
+     * @code
+     * BSerializer::SerializationAllocations a = BSerializer::MeasureAllocations(message);
+     * if (a.serialize.allocations) throw std::logic_error("Serialize allocated.");
+     * @endcode
+     * @tparam _T The type of the value. _T must conform to BSerializer::Serializable.
+     * @param[in] Value The value to measure.
+     * @param[in] Warm Whether to perform an unmeasured round trip first, so that the blocks BSerializer::BufferPool retains between calls are not counted.
+     * @return The heap activity of each step.
+     */
+    template <Serializable _T>
+    __forceinline SerializationAllocations MeasureAllocations(const _T& Value, bool Warm = true);
+}
+
+template <BSerializer::Serializable _T>
+__forceinline BSerializer::SerializationAllocations BSerializer::MeasureAllocations(const _T& Value, bool Warm) {
+    SerializationAllocations r;
+    size_t size = SerializedSize(Value);
+    std::unique_ptr<uint8_t[]> buffer(new uint8_t[size ? size : 1]);
+    alignas(_T) uint8_t value[sizeof(_T)];
+    if (Warm) {
+        void* p = buffer.get();
+        Serialize(p, Value);
+        const void* d = buffer.get();
+        Deserialize<_T>(d, (_T*)value);
+        ((_T*)value)->~_T();
+    }
+    r.serializedSize = CountAllocations([&] {
+        SerializedSize(Value);
+    });
+    r.serialize = CountAllocations([&] {
+        void* p = buffer.get();
+        Serialize(p, Value);
+    });
+    r.deserialize = CountAllocations([&] {
+        const void* d = buffer.get();
+        Deserialize<_T>(d, (_T*)value);
+    });
+    ((_T*)value)->~_T();
+    return r;
+}
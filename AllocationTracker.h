@@ -0,0 +1,222 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "Platform.h"
+
+namespace BSerializer {
+    /**
+     * @brief The heap activity of the calling thread over some interval.
+     */
+    struct AllocationCounts final {
+        /**
+         * @brief The quantity of allocations.
+         */
+        size_t allocations;
+        /**
+         * @brief The quantity of deallocations.
+         */
+        size_t deallocations;
+        /**
+         * @brief The total quantity of bytes allocated.
+         */
+        size_t bytes;
+        /**
+         * @brief The largest quantity of bytes live at once, counting only those allocated during the interval.
+         */
+        size_t peakBytes;
+    };
+
+    /**
+     * @brief Counts the heap allocations made by the calling thread between its construction and a call to BSerializer::AllocationScope::Counts. Scopes may be nested.
+     *
+     * Allocations made by BSerializer::BufferPool are always counted. Allocations through operator new are counted only if exactly one translation unit of the program defines BSERIALIZER_DEFINE_ALLOCATION_HOOKS before including this header, which replaces the global allocation functions with counting ones.
+     *
+     * Example, in a program that defines BSERIALIZER_DEFINE_ALLOCATION_HOOKS, where the data holds a non-empty std::vector<int>:
+     * @code
+     * const void* p = data;
+     * BSerializer::Deserialize<std::vector<int>>(p); // Leaves a scratch block in the pool of the calling thread.
+     * p = data;
+     * BSerializer::ExpectAllocations(1, [&] { value = BSerializer::Deserialize<std::vector<int>>(p); }); // Only the storage of the vector.
+     * @endcode
+     * The first call may allocate one more block, for the scratch memory drawn from BSerializer::BufferPool; without the hooks, the second call counts no allocations at all.
+     */
+    class AllocationScope final {
+    public:
+        /**
+         * @brief Begins counting.
+         */
+        __forceinline AllocationScope();
+        AllocationScope(const AllocationScope&) = delete;
+        AllocationScope& operator=(const AllocationScope&) = delete;
+        __forceinline ~AllocationScope();
+
+        /**
+         * @brief Returns the heap activity of the calling thread since the construction of this object.
+         * @return The heap activity of the calling thread since the construction of this object.
+         */
+        __forceinline AllocationCounts Counts() const;
+    private:
+        AllocationCounts start;
+        size_t live;
+        size_t outerPeak;
+    };
+
+    /**
+     * @brief Returns whether the counting global allocation functions are linked into the program.
+     * @return Whether a translation unit defined BSERIALIZER_DEFINE_ALLOCATION_HOOKS.
+     */
+    __forceinline bool AllocationHooksInstalled();
+    /**
+     * @brief Calls a function and counts the heap allocations it makes on the calling thread.
+     * @tparam _TFunc The type of the function.
+     * @param[in] Func The function to call.
+     * @return The heap activity of the call.
+     */
+    template <typename _TFunc>
+    __forceinline AllocationCounts CountAllocations(_TFunc&& Func);
+    /**
+     * @brief Calls a function and checks the quantity of heap allocations it makes on the calling thread.
+     * @tparam _TFunc The type of the function.
+     * @param[in] Expected The quantity of allocations the call must make.
+     * @param[in] Func The function to call.
+     * @exception std::logic_error Thrown if the call makes a different quantity of allocations.
+     */
+    template <typename _TFunc>
+    __forceinline void ExpectAllocations(size_t Expected, _TFunc&& Func);
+
+    namespace details {
+        struct allocationState {
+            size_t allocations;
+            size_t deallocations;
+            size_t bytes;
+            size_t live;
+            size_t peak;
+        };
+
+        inline thread_local allocationState allocations = { };
+
+        inline bool allocationHooks = false;
+
+        __forceinline void noteAllocation(size_t Size);
+
+        __forceinline void noteDeallocation(size_t Size);
+    }
+}
+
+__forceinline void BSerializer::details::noteAllocation(size_t Size) {
+    allocationState& s = allocations;
+    ++s.allocations;
+    s.bytes += Size;
+    s.live += Size;
+    if (s.live > s.peak) s.peak = s.live;
+}
+
+__forceinline void BSerializer::details::noteDeallocation(size_t Size) {
+    allocationState& s = allocations;
+    ++s.deallocations;
+    s.live -= Size;
+}
+
+__forceinline BSerializer::AllocationScope::AllocationScope() {
+    details::allocationState& s = details::allocations;
+    start = { s.allocations, s.deallocations, s.bytes, s.peak };
+    live = s.live;
+    outerPeak = s.peak;
+    s.peak = live;
+}
+
+__forceinline BSerializer::AllocationScope::~AllocationScope() {
+    details::allocationState& s = details::allocations;
+    if (outerPeak > s.peak) s.peak = outerPeak;
+}
+
+__forceinline BSerializer::AllocationCounts BSerializer::AllocationScope::Counts() const {
+    const details::allocationState& s = details::allocations;
+    return { s.allocations - start.allocations, s.deallocations - start.deallocations, s.bytes - start.bytes, s.peak - live };
+}
+
+__forceinline bool BSerializer::AllocationHooksInstalled() {
+    return details::allocationHooks;
+}
+
+template <typename _TFunc>
+__forceinline BSerializer::AllocationCounts BSerializer::CountAllocations(_TFunc&& Func) {
+    AllocationScope scope;
+    std::forward<_TFunc>(Func)();
+    return scope.Counts();
+}
+
+template <typename _TFunc>
+__forceinline void BSerializer::ExpectAllocations(size_t Expected, _TFunc&& Func) {
+    AllocationCounts c = CountAllocations(std::forward<_TFunc>(Func));
+    if (c.allocations != Expected) throw std::logic_error("Expected " + std::to_string(Expected) + " allocations, but " + std::to_string(c.allocations) + " were made (" + std::to_string(c.bytes) + " bytes).");
+}
+
+#ifdef BSERIALIZER_DEFINE_ALLOCATION_HOOKS
+namespace BSerializer {
+    namespace details {
+        constexpr size_t allocationHeaderSize = 16;
+
+        static const bool allocationHooksInstalled = (allocationHooks = true);
+
+        inline void* hookedAllocate(size_t Size, bool Throw);
+
+        inline void hookedFree(void* Block);
+    }
+}
+
+inline void* BSerializer::details::hookedAllocate(size_t Size, bool Throw) {
+    uint8_t* h = (uint8_t*)malloc(allocationHeaderSize + Size);
+    if (!h) {
+        if (Throw) throw std::bad_alloc();
+        return 0;
+    }
+    *(size_t*)h = Size;
+    noteAllocation(Size);
+    return h + allocationHeaderSize;
+}
+
+inline void BSerializer::details::hookedFree(void* Block) {
+    if (!Block) return;
+    uint8_t* h = (uint8_t*)Block - allocationHeaderSize;
+    noteDeallocation(*(size_t*)h);
+    free(h);
+}
+
+void* operator new(size_t Size) {
+    return BSerializer::details::hookedAllocate(Size, true);
+}
+
+void* operator new[](size_t Size) {
+    return BSerializer::details::hookedAllocate(Size, true);
+}
+
+void* operator new(size_t Size, const std::nothrow_t&) noexcept {
+    return BSerializer::details::hookedAllocate(Size, false);
+}
+
+void* operator new[](size_t Size, const std::nothrow_t&) noexcept {
+    return BSerializer::details::hookedAllocate(Size, false);
+}
+
+void operator delete(void* Block) noexcept {
+    BSerializer::details::hookedFree(Block);
+}
+
+void operator delete[](void* Block) noexcept {
+    BSerializer::details::hookedFree(Block);
+}
+
+void operator delete(void* Block, size_t) noexcept {
+    BSerializer::details::hookedFree(Block);
+}
+
+void operator delete[](void* Block, size_t) noexcept {
+    BSerializer::details::hookedFree(Block);
+}
+#endif
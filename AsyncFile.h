@@ -0,0 +1,734 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include "ChunkedSerializer.h"
+#include "PageBuffer.h"
+#include "Serializer.h"
+
+#if __has_include(<unistd.h>)
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define BSERIALIZER_IO_URING 1
+#endif
+
+namespace BSerializer {
+    namespace details {
+        struct asyncFileRequest {
+            bool write;
+            void* data;
+            size_t size;
+            uint64_t offset;
+            size_t tag;
+        };
+
+        /**
+         * @brief Submits reads and writes against a file and reports their completions. io_uring is used where the kernel provides it; otherwise a single worker thread performs the requests with pread and pwrite.
+         */
+        class asyncFileQueue final {
+        public:
+            inline asyncFileQueue(int Handle, unsigned Depth);
+            asyncFileQueue(const asyncFileQueue&) = delete;
+            asyncFileQueue& operator=(const asyncFileQueue&) = delete;
+            inline ~asyncFileQueue();
+
+            inline void Submit(const asyncFileRequest& Request);
+            inline size_t Wait(int64_t& Result);
+            __forceinline bool IsRing() const;
+        private:
+            int handle;
+#ifdef BSERIALIZER_IO_URING
+            int ring;
+            void* sqMemory;
+            size_t sqMemorySize;
+            void* cqMemory;
+            size_t cqMemorySize;
+            io_uring_sqe* sqes;
+            size_t sqesSize;
+            unsigned* sqTail;
+            unsigned* sqMask;
+            unsigned* sqArray;
+            unsigned* cqHead;
+            unsigned* cqTail;
+            unsigned* cqMask;
+            io_uring_cqe* cqes;
+
+            inline bool SetupRing(unsigned Depth);
+#endif
+            std::thread worker;
+            std::mutex mutex;
+            std::condition_variable requestReady;
+            std::condition_variable completionReady;
+            std::deque<asyncFileRequest> requests;
+            std::deque<std::pair<size_t, int64_t>> completions;
+            bool stopping;
+
+            inline void Work();
+        };
+
+        __forceinline int enableDirect(int Handle, size_t ChunkSize, uint64_t Offset);
+
+        constexpr size_t directAlignment = 4096;
+
+        struct asyncFileChunk {
+            PageBuffer memory;
+            uint8_t* data;
+            size_t size;
+            size_t done;
+            uint64_t offset;
+            bool busy;
+        };
+    }
+
+    /**
+     * @brief Serializes values into a file through a set of chunks that are written asynchronously, so that serialization continues into the next chunk while earlier ones are being written.
+     *
+     * Each value is written as a record: its serialized size as a `uint64_t`, followed by the value, both in the default little-endian format. A value larger than the space left in the current chunk is split across chunks with a BSerializer::ChunkedSerializer, so records may be of any size.
+     * Writes are submitted through io_uring where the kernel provides it, and through a single worker thread otherwise.
+     * In direct mode, the file is switched to `O_DIRECT` so that chunks bypass the page cache. Each flush then pads the final chunk to a whole block and truncates the file to its logical end; the partial block is kept and rewritten by the next flush.
+     * Whether direct mode or huge pages pay off depends on the device and the size of the data; BSerializer::BenchmarkAsyncFile compares them on a given file.
+     *
+     * Example:
+     * @code
+     * BSerializer::AsyncFileWriter writer(fd);
+     * for (const Record& r : snapshot) writer.Serialize(r);
+     * writer.Flush();
+     * @endcode
+     */
+    class AsyncFileWriter final {
+    public:
+        /**
+         * @brief Attaches to a file opened for writing.
+         * @param[in] Handle The file descriptor. The writer does not take ownership of it.
+         * @param[in] ChunkSize The size of each chunk, in bytes.
+         * @param[in] Depth The quantity of chunks, and so the maximum quantity of writes in flight plus the one being filled.
+         * @param[in] Offset The offset in the file at which to begin writing.
+         * @param[in] Direct Whether to write with `O_DIRECT`, bypassing the page cache. If so, ChunkSize and Offset must be multiples of 4096, and the file is truncated at its logical end on each flush.
+         * @param[in] Pages The kind of pages backing the chunks.
+         */
+        inline AsyncFileWriter(int Handle, size_t ChunkSize = 1 << 20, size_t Depth = 4, uint64_t Offset = 0, bool Direct = false, HugePages Pages = HugePages::None);
+        AsyncFileWriter(const AsyncFileWriter&) = delete;
+        AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+        /**
+         * @brief Waits for writes in flight to finish. Data that has not been flushed is discarded, and errors are not reported; call Flush first.
+         */
+        inline ~AsyncFileWriter();
+
+        /**
+         * @brief Appends a value to the file as a record.
+         * @tparam _T The type of the value serialized. _T must conform to BSerializer::Serializable.
+         * @param[in] Value The value to serialize. It is fully serialized before this function returns.
+         */
+        template <Serializable _T>
+        __forceinline void Serialize(const _T& Value);
+        /**
+         * @brief Appends raw data to the file, without a record header.
+         * @param[in] Data A pointer to the data.
+         * @param[in] Size The size of the data, in bytes.
+         */
+        inline void Write(const void* Data, size_t Size);
+        /**
+         * @brief Submits the partially filled chunk and waits for all writes to finish.
+         */
+        inline void Flush();
+        /**
+         * @brief Returns the offset in the file at which the next byte will be written.
+         * @return The offset in the file at which the next byte will be written.
+         */
+        __forceinline uint64_t Offset() const;
+    private:
+        details::asyncFileQueue queue;
+        std::vector<details::asyncFileChunk> chunks;
+        size_t chunkSize;
+        size_t current;
+        size_t inFlight;
+        uint64_t offset;
+        int handle;
+        int restoreFlags;
+
+        inline void SubmitChunk();
+        inline void Complete();
+    };
+
+    /**
+     * @brief Deserializes records written by BSerializer::AsyncFileWriter, keeping several reads ahead of the values being deserialized.
+     *
+     * Values are deserialized in place from the chunk that holds them; a record that spans chunks is first gathered into a contiguous spill buffer.
+     */
+    class AsyncFileReader final {
+    public:
+        /**
+         * @brief Attaches to a file opened for reading and begins reading ahead.
+         * @param[in] Handle The file descriptor. The reader does not take ownership of it.
+         * @param[in] ChunkSize The size of each chunk, in bytes.
+         * @param[in] Depth The quantity of chunks, and so the maximum quantity of reads in flight.
+         * @param[in] Offset The offset in the file at which to begin reading.
+         * @param[in] Direct Whether to read with `O_DIRECT`, bypassing the page cache. If so, ChunkSize and Offset must be multiples of 4096.
+         * @param[in] Pages The kind of pages backing the chunks.
+         */
+        inline AsyncFileReader(int Handle, size_t ChunkSize = 1 << 20, size_t Depth = 4, uint64_t Offset = 0, bool Direct = false, HugePages Pages = HugePages::None);
+        AsyncFileReader(const AsyncFileReader&) = delete;
+        AsyncFileReader& operator=(const AsyncFileReader&) = delete;
+        /**
+         * @brief Waits for reads in flight to finish.
+         */
+        inline ~AsyncFileReader();
+
+        /**
+         * @brief Deserializes the next record.
+         * @tparam _T The type of the value deserialized. _T must conform to BSerializer::Serializable.
+         * @param[out] Value A pointer to the location in memory in which the deserialized value will be placed.
+         * @return Whether a record was read. If not, the end of the file has been reached and nothing is written to Value.
+         */
+        template <Serializable _T>
+        __forceinline bool Deserialize(_T* Value);
+        /**
+         * @brief Reads raw data from the file.
+         * @param[out] Data A pointer to the destination of the data.
+         * @param[in] Size The quantity of bytes to read.
+         * @return The quantity of bytes read. This is less than Size only if the end of the file has been reached.
+         */
+        inline size_t Read(void* Data, size_t Size);
+    private:
+        details::asyncFileQueue queue;
+        std::vector<details::asyncFileChunk> chunks;
+        std::vector<uint8_t> spill;
+        size_t chunkSize;
+        size_t current;
+        size_t position;
+        uint64_t offset;
+        bool end;
+        int handle;
+        int restoreFlags;
+
+        inline void SubmitChunk(size_t Index);
+        inline bool Advance();
+        inline const void* Contiguous(size_t Size);
+    };
+
+    /**
+     * @brief The timings of one configuration in BSerializer::BenchmarkAsyncFile.
+     */
+    struct AsyncFileBenchmarkResult final {
+        /**
+         * @brief Whether the file was written and read with `O_DIRECT`.
+         */
+        bool direct;
+        /**
+         * @brief The kind of pages backing the chunks.
+         */
+        HugePages pages;
+        /**
+         * @brief Whether the configuration could be run. Direct configurations are skipped where the file or platform does not accept `O_DIRECT`; the timings are then zero.
+         */
+        bool supported;
+        /**
+         * @brief The size of the file written, in bytes.
+         */
+        uint64_t bytes;
+        /**
+         * @brief The throughput of serializing the values, flushing and syncing the file, in bytes per second.
+         */
+        double writeBytesPerSecond;
+        /**
+         * @brief The throughput of deserializing the values back from a cold page cache, in bytes per second.
+         */
+        double readBytesPerSecond;
+    };
+
+    /**
+     * @brief Writes and reads back a set of values through BSerializer::AsyncFileWriter and BSerializer::AsyncFileReader with buffered and direct I/O, each with every kind of page, and times both directions.
+     *
+     * Each configuration truncates the file, serializes all values, flushes and calls `fdatasync`, so that buffered writes are charged for reaching the device. The page cache for the file is then dropped with `posix_fadvise` before the values are deserialized, so that buffered reads are not served from memory.
+     * The file should live on the device of interest; `tmpfs` holds everything in memory and does not accept `O_DIRECT`.
+     *
+     * Example:
+     * @code
+     * for (const BSerializer::AsyncFileBenchmarkResult& r : BSerializer::BenchmarkAsyncFile(fd, snapshot)) {
+     *     printf("%d %d %.0f %.0f\n", r.direct, (int)r.pages, r.writeBytesPerSecond, r.readBytesPerSecond);
+     * }
+     * @endcode
+     * @tparam _T The type of the values. _T must conform to BSerializer::Serializable.
+     * @param[in] Handle The file descriptor, opened for reading and writing. Its contents are overwritten, and it is left truncated to the last configuration's output.
+     * @param[in] Values The values to write and read back.
+     * @param[in] ChunkSize The size of each chunk, in bytes. It must be a multiple of 4096 for the direct configurations to run.
+     * @param[in] Depth The quantity of chunks.
+     * @return One result per configuration: buffered before direct, and within each, HugePages::None, HugePages::Transparent and HugePages::Explicit.
+     * @exception std::system_error Thrown if truncating or syncing the file fails.
+     */
+    template <Serializable _T>
+    inline std::vector<AsyncFileBenchmarkResult> BenchmarkAsyncFile(int Handle, const std::vector<_T>& Values, size_t ChunkSize = 1 << 20, size_t Depth = 4);
+}
+
+inline BSerializer::details::asyncFileQueue::asyncFileQueue(int Handle, unsigned Depth)
+    : handle(Handle), stopping(false) {
+#ifdef BSERIALIZER_IO_URING
+    ring = -1;
+    if (SetupRing(Depth)) return;
+#endif
+    worker = std::thread(&asyncFileQueue::Work, this);
+}
+
+inline BSerializer::details::asyncFileQueue::~asyncFileQueue() {
+#ifdef BSERIALIZER_IO_URING
+    if (ring >= 0) {
+        munmap(sqes, sqesSize);
+        if (cqMemory != sqMemory) munmap(cqMemory, cqMemorySize);
+        munmap(sqMemory, sqMemorySize);
+        close(ring);
+        return;
+    }
+#endif
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    requestReady.notify_one();
+    worker.join();
+}
+
+#ifdef BSERIALIZER_IO_URING
+inline bool BSerializer::details::asyncFileQueue::SetupRing(unsigned Depth) {
+    io_uring_params p = { };
+    int fd = (int)syscall(__NR_io_uring_setup, Depth, &p);
+    if (fd < 0) return false;
+    sqMemorySize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    cqMemorySize = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        if (cqMemorySize > sqMemorySize) sqMemorySize = cqMemorySize;
+        cqMemorySize = sqMemorySize;
+    }
+    sqMemory = mmap(0, sqMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (sqMemory == MAP_FAILED) {
+        close(fd);
+        return false;
+    }
+    if (p.features & IORING_FEAT_SINGLE_MMAP) cqMemory = sqMemory;
+    else {
+        cqMemory = mmap(0, cqMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (cqMemory == MAP_FAILED) {
+            munmap(sqMemory, sqMemorySize);
+            close(fd);
+            return false;
+        }
+    }
+    sqesSize = p.sq_entries * sizeof(io_uring_sqe);
+    sqes = (io_uring_sqe*)mmap(0, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        if (cqMemory != sqMemory) munmap(cqMemory, cqMemorySize);
+        munmap(sqMemory, sqMemorySize);
+        close(fd);
+        return false;
+    }
+    uint8_t* sq = (uint8_t*)sqMemory;
+    uint8_t* cq = (uint8_t*)cqMemory;
+    sqTail = (unsigned*)(sq + p.sq_off.tail);
+    sqMask = (unsigned*)(sq + p.sq_off.ring_mask);
+    sqArray = (unsigned*)(sq + p.sq_off.array);
+    cqHead = (unsigned*)(cq + p.cq_off.head);
+    cqTail = (unsigned*)(cq + p.cq_off.tail);
+    cqMask = (unsigned*)(cq + p.cq_off.ring_mask);
+    cqes = (io_uring_cqe*)(cq + p.cq_off.cqes);
+    ring = fd;
+    return true;
+}
+#endif
+
+inline void BSerializer::details::asyncFileQueue::Submit(const asyncFileRequest& Request) {
+#ifdef BSERIALIZER_IO_URING
+    if (ring >= 0) {
+        unsigned tail = *sqTail;
+        unsigned idx = tail & *sqMask;
+        io_uring_sqe& sqe = sqes[idx];
+        sqe = { };
+        sqe.opcode = Request.write ? IORING_OP_WRITE : IORING_OP_READ;
+        sqe.fd = handle;
+        sqe.addr = (uint64_t)(uintptr_t)Request.data;
+        sqe.len = (uint32_t)Request.size;
+        sqe.off = Request.offset;
+        sqe.user_data = Request.tag;
+        sqArray[idx] = idx;
+        std::atomic_ref<unsigned>(*sqTail).store(tail + 1, std::memory_order_release);
+        while (syscall(__NR_io_uring_enter, ring, 1, 0, 0, 0, 0) < 0) {
+            if (errno != EINTR && errno != EAGAIN) throw std::system_error(errno, std::system_category(), "io_uring_enter");
+        }
+        return;
+    }
+#endif
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        requests.push_back(Request);
+    }
+    requestReady.notify_one();
+}
+
+inline size_t BSerializer::details::asyncFileQueue::Wait(int64_t& Result) {
+#ifdef BSERIALIZER_IO_URING
+    if (ring >= 0) {
+        while (true) {
+            unsigned head = *cqHead;
+            if (head != std::atomic_ref<unsigned>(*cqTail).load(std::memory_order_acquire)) {
+                const io_uring_cqe& cqe = cqes[head & *cqMask];
+                size_t tag = (size_t)cqe.user_data;
+                Result = cqe.res;
+                std::atomic_ref<unsigned>(*cqHead).store(head + 1, std::memory_order_release);
+                return tag;
+            }
+            if (syscall(__NR_io_uring_enter, ring, 0, 1, IORING_ENTER_GETEVENTS, 0, 0) < 0 && errno != EINTR) {
+                throw std::system_error(errno, std::system_category(), "io_uring_enter");
+            }
+        }
+    }
+#endif
+    std::unique_lock<std::mutex> lock(mutex);
+    completionReady.wait(lock, [this] { return !completions.empty(); });
+    std::pair<size_t, int64_t> c = completions.front();
+    completions.pop_front();
+    Result = c.second;
+    return c.first;
+}
+
+__forceinline bool BSerializer::details::asyncFileQueue::IsRing() const {
+#ifdef BSERIALIZER_IO_URING
+    return ring >= 0;
+#else
+    return false;
+#endif
+}
+
+inline void BSerializer::details::asyncFileQueue::Work() {
+    while (true) {
+        asyncFileRequest r;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            requestReady.wait(lock, [this] { return stopping || !requests.empty(); });
+            if (requests.empty()) return;
+            r = requests.front();
+            requests.pop_front();
+        }
+        ssize_t n;
+        do n = r.write ? pwrite(handle, r.data, r.size, (off_t)r.offset) : pread(handle, r.data, r.size, (off_t)r.offset);
+        while (n < 0 && errno == EINTR);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            completions.emplace_back(r.tag, n < 0 ? -(int64_t)errno : (int64_t)n);
+        }
+        completionReady.notify_one();
+    }
+}
+
+__forceinline int BSerializer::details::enableDirect(int Handle, size_t ChunkSize, uint64_t Offset) {
+#ifdef O_DIRECT
+    if (ChunkSize % directAlignment || Offset % directAlignment) throw std::invalid_argument("'ChunkSize' and 'Offset' must be multiples of 4096 for direct I/O.");
+    int flags = fcntl(Handle, F_GETFL);
+    if (flags < 0 || fcntl(Handle, F_SETFL, flags | O_DIRECT)) throw std::system_error(errno, std::system_category(), "fcntl");
+    return flags;
+#else
+    throw std::invalid_argument("Direct I/O is not supported on this platform.");
+#endif
+}
+
+inline BSerializer::AsyncFileWriter::AsyncFileWriter(int Handle, size_t ChunkSize, size_t Depth, uint64_t Offset, bool Direct, HugePages Pages)
+    : queue(Handle, (unsigned)(Depth ? Depth : 1)), chunks(Depth ? Depth : 1), chunkSize(ChunkSize), current(0), inFlight(0), offset(Offset), handle(Handle), restoreFlags(-1) {
+    if (Direct) restoreFlags = details::enableDirect(Handle, ChunkSize, Offset);
+    for (details::asyncFileChunk& c : chunks) {
+        c.memory = PageBuffer(chunkSize, Pages);
+        c.data = (uint8_t*)c.memory.Data();
+        c.size = 0;
+        c.done = 0;
+        c.offset = 0;
+        c.busy = false;
+    }
+}
+
+inline BSerializer::AsyncFileWriter::~AsyncFileWriter() {
+    while (inFlight) {
+        int64_t r;
+        chunks[queue.Wait(r)].busy = false;
+        --inFlight;
+    }
+    if (restoreFlags >= 0) fcntl(handle, F_SETFL, restoreFlags);
+}
+
+template <BSerializer::Serializable _T>
+__forceinline void BSerializer::AsyncFileWriter::Serialize(const _T& Value) {
+    size_t size = SerializedSize(Value);
+    uint64_t header = ToFromLittleEndian((uint64_t)size);
+    Write(&header, sizeof(uint64_t));
+    details::asyncFileChunk& c = chunks[current];
+    if (chunkSize - c.size >= size) {
+        void* p = c.data + c.size;
+        BSerializer::Serialize(p, Value);
+        c.size += size;
+        return;
+    }
+    ChunkedSerializer serializer(Value);
+    while (true) {
+        details::asyncFileChunk& d = chunks[current];
+        void* p = d.data + d.size;
+        ChunkResult r = serializer.Serialize(p, chunkSize - d.size);
+        d.size = (uint8_t*)p - d.data;
+        if (r == ChunkResult::Complete) break;
+        SubmitChunk();
+    }
+}
+
+inline void BSerializer::AsyncFileWriter::Write(const void* Data, size_t Size) {
+    const uint8_t* p = (const uint8_t*)Data;
+    while (Size) {
+        details::asyncFileChunk& c = chunks[current];
+        size_t s = chunkSize - c.size;
+        if (s > Size) s = Size;
+        memcpy(c.data + c.size, p, s);
+        c.size += s;
+        p += s;
+        Size -= s;
+        if (c.size == chunkSize) SubmitChunk();
+    }
+}
+
+inline void BSerializer::AsyncFileWriter::Flush() {
+    size_t last = current;
+    size_t size = chunks[last].size;
+    if (size) SubmitChunk();
+    while (inFlight) Complete();
+    if (restoreFlags >= 0 && size) {
+        if (ftruncate(handle, (off_t)offset)) throw std::system_error(errno, std::system_category(), "ftruncate");
+        size_t tail = size % details::directAlignment;
+        if (tail) {
+            details::asyncFileChunk& c = chunks[current];
+            memmove(c.data, chunks[last].data + (size - tail), tail);
+            c.size = tail;
+            offset -= tail;
+        }
+    }
+}
+
+__forceinline uint64_t BSerializer::AsyncFileWriter::Offset() const {
+    return offset + chunks[current].size;
+}
+
+inline void BSerializer::AsyncFileWriter::SubmitChunk() {
+    details::asyncFileChunk& c = chunks[current];
+    c.done = 0;
+    c.offset = offset;
+    c.busy = true;
+    offset += c.size;
+    if (restoreFlags >= 0 && c.size % details::directAlignment) {
+        size_t s = (c.size + details::directAlignment - 1) & ~(details::directAlignment - 1);
+        memset(c.data + c.size, 0, s - c.size);
+        c.size = s;
+    }
+    queue.Submit({ true, c.data, c.size, c.offset, current });
+    ++inFlight;
+    for (size_t i = 1; i <= chunks.size(); ++i) {
+        size_t n = (current + i) % chunks.size();
+        if (!chunks[n].busy) {
+            current = n;
+            return;
+        }
+    }
+    while (true) {
+        Complete();
+        for (size_t n = 0; n < chunks.size(); ++n) {
+            if (!chunks[n].busy) {
+                current = n;
+                return;
+            }
+        }
+    }
+}
+
+inline void BSerializer::AsyncFileWriter::Complete() {
+    int64_t r;
+    size_t tag = queue.Wait(r);
+    details::asyncFileChunk& c = chunks[tag];
+    if (r < 0) {
+        c.busy = false;
+        c.size = 0;
+        --inFlight;
+        throw std::system_error((int)-r, std::system_category(), "write");
+    }
+    c.done += (size_t)r;
+    if (c.done < c.size) {
+        if (!r) {
+            c.busy = false;
+            c.size = 0;
+            --inFlight;
+            throw std::system_error(EIO, std::system_category(), "write");
+        }
+        queue.Submit({ true, c.data + c.done, c.size - c.done, c.offset + c.done, tag });
+        return;
+    }
+    c.busy = false;
+    c.size = 0;
+    --inFlight;
+}
+
+inline BSerializer::AsyncFileReader::AsyncFileReader(int Handle, size_t ChunkSize, size_t Depth, uint64_t Offset, bool Direct, HugePages Pages)
+    : queue(Handle, (unsigned)(Depth ? Depth : 1)), chunks(Depth ? Depth : 1), chunkSize(ChunkSize), current(0), position(0), offset(Offset), end(false), handle(Handle), restoreFlags(-1) {
+    if (Direct) restoreFlags = details::enableDirect(Handle, ChunkSize, Offset);
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        chunks[i].memory = PageBuffer(chunkSize, Pages);
+        chunks[i].data = (uint8_t*)chunks[i].memory.Data();
+        SubmitChunk(i);
+    }
+}
+
+inline BSerializer::AsyncFileReader::~AsyncFileReader() {
+    for (details::asyncFileChunk& c : chunks) {
+        while (c.busy) {
+            int64_t r;
+            chunks[queue.Wait(r)].busy = false;
+        }
+    }
+    if (restoreFlags >= 0) fcntl(handle, F_SETFL, restoreFlags);
+}
+
+template <BSerializer::Serializable _T>
+__forceinline bool BSerializer::AsyncFileReader::Deserialize(_T* Value) {
+    uint64_t size;
+    if (Read(&size, sizeof(uint64_t)) < sizeof(uint64_t)) return false;
+    size = ToFromLittleEndian(size);
+    const void* p = Contiguous((size_t)size);
+    if (!p) throw std::out_of_range("The file ended in the middle of a record.");
+    BSerializer::Deserialize(p, Value);
+    return true;
+}
+
+inline size_t BSerializer::AsyncFileReader::Read(void* Data, size_t Size) {
+    uint8_t* p = (uint8_t*)Data;
+    size_t t = 0;
+    while (t < Size) {
+        details::asyncFileChunk& c = chunks[current];
+        if (c.busy || position == c.size) {
+            if (!Advance()) break;
+            continue;
+        }
+        size_t s = c.size - position;
+        if (s > Size - t) s = Size - t;
+        memcpy(p + t, c.data + position, s);
+        position += s;
+        t += s;
+    }
+    return t;
+}
+
+inline void BSerializer::AsyncFileReader::SubmitChunk(size_t Index) {
+    details::asyncFileChunk& c = chunks[Index];
+    c.size = 0;
+    c.done = 0;
+    c.offset = offset;
+    c.busy = true;
+    offset += chunkSize;
+    queue.Submit({ false, c.data, chunkSize, c.offset, Index });
+}
+
+inline bool BSerializer::AsyncFileReader::Advance() {
+    details::asyncFileChunk& c = chunks[current];
+    if (!c.busy) {
+        if (c.size < chunkSize) return false;
+        if (end) c.size = 0;
+        else SubmitChunk(current);
+        current = (current + 1) % chunks.size();
+        position = 0;
+    }
+    while (chunks[current].busy) {
+        int64_t r;
+        size_t tag = queue.Wait(r);
+        details::asyncFileChunk& d = chunks[tag];
+        if (r < 0) {
+            d.busy = false;
+            throw std::system_error((int)-r, std::system_category(), "read");
+        }
+        d.done += (size_t)r;
+        if (r && d.done < chunkSize && restoreFlags < 0) {
+            queue.Submit({ false, d.data + d.done, chunkSize - d.done, d.offset + d.done, tag });
+            continue;
+        }
+        d.size = d.done;
+        d.busy = false;
+        if (d.size < chunkSize) end = true;
+    }
+    return chunks[current].size != 0;
+}
+
+inline const void* BSerializer::AsyncFileReader::Contiguous(size_t Size) {
+    details::asyncFileChunk& c = chunks[current];
+    if (!c.busy && c.size - position >= Size) {
+        const void* p = c.data + position;
+        position += Size;
+        return p;
+    }
+    spill.resize(Size);
+    if (Read(spill.data(), Size) < Size) return 0;
+    return spill.data();
+}
+
+template <BSerializer::Serializable _T>
+inline std::vector<BSerializer::AsyncFileBenchmarkResult> BSerializer::BenchmarkAsyncFile(int Handle, const std::vector<_T>& Values, size_t ChunkSize, size_t Depth) {
+    std::vector<AsyncFileBenchmarkResult> results;
+    for (bool direct : { false, true }) {
+        for (HugePages pages : { HugePages::None, HugePages::Transparent, HugePages::Explicit }) {
+            AsyncFileBenchmarkResult r = { direct, pages, true, 0, 0, 0 };
+            if (ftruncate(Handle, 0)) throw std::system_error(errno, std::system_category(), "ftruncate");
+            auto t0 = std::chrono::steady_clock::now();
+            {
+                std::optional<AsyncFileWriter> writer;
+                try {
+                    writer.emplace(Handle, ChunkSize, Depth, 0, direct, pages);
+                }
+                catch (const std::invalid_argument&) {
+                    if (!direct) throw;
+                    r.supported = false;
+                }
+                catch (const std::system_error&) {
+                    if (!direct) throw;
+                    r.supported = false;
+                }
+                if (!r.supported) {
+                    results.push_back(r);
+                    continue;
+                }
+                for (const _T& v : Values) writer->Serialize(v);
+                writer->Flush();
+                r.bytes = writer->Offset();
+            }
+            if (fdatasync(Handle)) throw std::system_error(errno, std::system_category(), "fdatasync");
+            auto t1 = std::chrono::steady_clock::now();
+#ifdef POSIX_FADV_DONTNEED
+            posix_fadvise(Handle, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+            auto t2 = std::chrono::steady_clock::now();
+            {
+                AsyncFileReader reader(Handle, ChunkSize, Depth, 0, direct, pages);
+                alignas(_T) uint8_t storage[sizeof(_T)];
+                for (size_t i = 0; i < Values.size(); ++i) {
+                    if (!reader.Deserialize((_T*)storage)) break;
+                    ((_T*)storage)->~_T();
+                }
+            }
+            auto t3 = std::chrono::steady_clock::now();
+            r.writeBytesPerSecond = r.bytes / std::chrono::duration<double>(t1 - t0).count();
+            r.readBytesPerSecond = r.bytes / std::chrono::duration<double>(t3 - t2).count();
+            results.push_back(r);
+        }
+    }
+    return results;
+}
+#endif
@@ -0,0 +1,377 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <utility>
+#include "Platform.h"
+#include "AllocationTracker.h"
+
+namespace BSerializer {
+    namespace details {
+        constexpr size_t poolHeaderSize = 16;
+        constexpr size_t poolMinimumClass = 6;
+        constexpr size_t poolClassCount = 21;
+
+        struct poolShared {
+            std::mutex lock;
+            std::atomic<void*> remote;
+            size_t remoteCount;
+            size_t orphans;
+            bool alive;
+        };
+
+        __forceinline size_t poolClass(size_t Size);
+
+        __forceinline poolShared*& poolOwner(void* Block);
+
+        inline void poolFree(void* Block);
+    }
+
+    /**
+     * @brief Counters describing the activity of a BSerializer::BufferPool.
+     */
+    struct BufferPoolStatistics final {
+        /**
+         * @brief The quantity of acquisitions satisfied by a retained block.
+         */
+        size_t hits;
+        /**
+         * @brief The quantity of acquisitions that had to allocate a new block.
+         */
+        size_t misses;
+        /**
+         * @brief The quantity of blocks released through the pool that were freed instead of retained, because they were too large, the pool that acquired them was at its retention limit, or that pool had been destroyed.
+         */
+        size_t discards;
+        /**
+         * @brief The quantity of bytes currently held by the pool for reuse.
+         */
+        size_t retained;
+        /**
+         * @brief The largest quantity of bytes ever held by the pool for reuse.
+         */
+        size_t peakRetained;
+    };
+
+    /**
+     * @brief A size-classed cache of heap blocks, so that repeated serialization and deserialization do not contend in the allocator.
+     *
+     * Each thread has its own pool, returned by BSerializer::BufferPool::Local; BSerializer draws the scratch memory of collection deserialization from it. Blocks are grouped into power-of-two classes from 64 bytes to 64 MiB, and larger blocks bypass the pool.
+     * A block may be released on any thread, through any pool; it always returns to the pool that acquired it, so memory does not pile up in a thread that only consumes. A block released on another thread is queued under a lock and taken back by its pool the next time that pool runs out of blocks of its class. If the pool has been destroyed in the meantime, the block is freed.
+     */
+    class BufferPool final {
+    public:
+        /**
+         * @brief Creates an empty pool.
+         * @param[in] RetentionLimit The maximum quantity of bytes the pool holds for reuse.
+         */
+        inline explicit BufferPool(size_t RetentionLimit = 16 << 20);
+        BufferPool(const BufferPool&) = delete;
+        BufferPool& operator=(const BufferPool&) = delete;
+        inline ~BufferPool();
+
+        /**
+         * @brief Returns the pool of the calling thread.
+         * @return The pool of the calling thread.
+         */
+        static __forceinline BufferPool& Local();
+
+        /**
+         * @brief Returns a block of at least the given size, aligned for any fundamental type.
+         * @param[in] Size The minimum size of the block, in bytes.
+         * @return A pointer to the block. It must be returned with BSerializer::BufferPool::Release.
+         */
+        inline void* Acquire(size_t Size);
+        /**
+         * @brief Returns a block to the pool that acquired it, which either retains it or frees it.
+         * @param[in] Block A pointer returned by BSerializer::BufferPool::Acquire of any pool, or a null pointer.
+         */
+        inline void Release(void* Block);
+        /**
+         * @brief Returns the usable size of a block.
+         * @param[in] Block A pointer returned by BSerializer::BufferPool::Acquire.
+         * @return The usable size of the block, in bytes, which is at least the size requested.
+         */
+        static __forceinline size_t Capacity(const void* Block);
+        /**
+         * @brief Frees every block the pool holds for reuse, including those released to it by other threads.
+         */
+        inline void Trim();
+
+        /**
+         * @brief Sets the maximum quantity of bytes the pool holds for reuse. Blocks held beyond the new limit are freed.
+         * @param[in] RetentionLimit The maximum quantity of bytes the pool holds for reuse.
+         */
+        inline void SetRetentionLimit(size_t RetentionLimit);
+        /**
+         * @brief Returns the maximum quantity of bytes the pool holds for reuse.
+         * @return The maximum quantity of bytes the pool holds for reuse.
+         */
+        __forceinline size_t RetentionLimit() const;
+        /**
+         * @brief Returns the counters of the pool.
+         * @return The counters of the pool.
+         */
+        __forceinline BufferPoolStatistics Statistics() const;
+    private:
+        void* lists[details::poolClassCount];
+        size_t limit;
+        size_t outstanding;
+        BufferPoolStatistics stats;
+        details::poolShared* shared;
+
+        inline void Collect();
+        inline void Retain(void* Block, size_t Capacity);
+    };
+
+    /**
+     * @brief A block acquired from the pool of the calling thread, returned to that pool when destroyed on any thread. Suitable as an output buffer for serialization.
+     *
+     * Example:
+     * @code
+     * BSerializer::PooledBuffer buffer(BSerializer::SerializedSize(value));
+     * void* p = buffer.Data();
+     * BSerializer::Serialize(p, value);
+     * @endcode
+     */
+    class PooledBuffer final {
+    public:
+        /**
+         * @brief Creates an object that owns no block.
+         */
+        __forceinline PooledBuffer();
+        /**
+         * @brief Acquires a block of at least the given size from the pool of the calling thread.
+         * @param[in] Size The minimum size of the block, in bytes.
+         */
+        __forceinline explicit PooledBuffer(size_t Size);
+        __forceinline PooledBuffer(PooledBuffer&& Other);
+        __forceinline PooledBuffer& operator=(PooledBuffer&& Other);
+        PooledBuffer(const PooledBuffer&) = delete;
+        PooledBuffer& operator=(const PooledBuffer&) = delete;
+        __forceinline ~PooledBuffer();
+
+        /**
+         * @brief Returns a pointer to the block.
+         * @return A pointer to the block, or a null pointer if the object owns no block.
+         */
+        __forceinline void* Data() const;
+        /**
+         * @brief Returns the usable size of the block.
+         * @return The usable size of the block, in bytes, or zero if the object owns no block.
+         */
+        __forceinline size_t Capacity() const;
+    private:
+        void* data;
+    };
+}
+
+__forceinline size_t BSerializer::details::poolClass(size_t Size) {
+    size_t c = Size > 1 ? (size_t)std::bit_width(Size - 1) : 0;
+    return c < poolMinimumClass ? 0 : c - poolMinimumClass;
+}
+
+__forceinline BSerializer::details::poolShared*& BSerializer::details::poolOwner(void* Block) {
+    return *(poolShared**)((uint8_t*)Block - poolHeaderSize + sizeof(size_t));
+}
+
+inline void BSerializer::details::poolFree(void* Block) {
+    noteDeallocation(BufferPool::Capacity(Block));
+    free((uint8_t*)Block - poolHeaderSize);
+}
+
+inline BSerializer::BufferPool::BufferPool(size_t RetentionLimit)
+    : lists(), limit(RetentionLimit), outstanding(0), stats() {
+    void* s = malloc(sizeof(details::poolShared));
+    if (!s) {
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+        throw std::bad_alloc();
+#else
+        std::abort();
+#endif
+    }
+    shared = new (s) details::poolShared{ {}, nullptr, 0, 0, true };
+}
+
+inline BSerializer::BufferPool::~BufferPool() {
+    Trim();
+    void* b;
+    bool last;
+    {
+        std::lock_guard<std::mutex> guard(shared->lock);
+        shared->alive = false;
+        b = shared->remote.exchange(nullptr, std::memory_order_relaxed);
+        shared->orphans = outstanding - shared->remoteCount;
+        last = !shared->orphans;
+    }
+    while (b) {
+        void* next = *(void**)b;
+        details::poolFree(b);
+        b = next;
+    }
+    if (last) {
+        shared->~poolShared();
+        free(shared);
+    }
+}
+
+__forceinline BSerializer::BufferPool& BSerializer::BufferPool::Local() {
+    static thread_local BufferPool pool;
+    return pool;
+}
+
+inline void* BSerializer::BufferPool::Acquire(size_t Size) {
+    size_t c = details::poolClass(Size);
+    if (c < details::poolClassCount) {
+        if (!lists[c] && shared->remote.load(std::memory_order_relaxed)) Collect();
+        if (void* b = lists[c]) {
+            lists[c] = *(void**)b;
+            stats.retained -= (size_t)1 << (c + details::poolMinimumClass);
+            ++stats.hits;
+            ++outstanding;
+            return b;
+        }
+    }
+    ++stats.misses;
+    size_t capacity = c < details::poolClassCount ? (size_t)1 << (c + details::poolMinimumClass) : Size;
+    uint8_t* h = (uint8_t*)malloc(details::poolHeaderSize + capacity);
+    if (!h) {
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+        throw std::bad_alloc();
+#else
+        std::abort();
+#endif
+    }
+    details::noteAllocation(capacity);
+    *(size_t*)h = capacity;
+    void* b = h + details::poolHeaderSize;
+    if (c < details::poolClassCount) {
+        details::poolOwner(b) = shared;
+        ++outstanding;
+    }
+    else details::poolOwner(b) = 0;
+    return b;
+}
+
+inline void BSerializer::BufferPool::Release(void* Block) {
+    if (!Block) return;
+    details::poolShared* owner = details::poolOwner(Block);
+    if (owner == shared) {
+        --outstanding;
+        Retain(Block, Capacity(Block));
+        return;
+    }
+    if (owner) {
+        std::unique_lock<std::mutex> guard(owner->lock);
+        if (owner->alive) {
+            *(void**)Block = owner->remote.load(std::memory_order_relaxed);
+            owner->remote.store(Block, std::memory_order_relaxed);
+            ++owner->remoteCount;
+            return;
+        }
+        bool last = !--owner->orphans;
+        guard.unlock();
+        if (last) {
+            owner->~poolShared();
+            free(owner);
+        }
+    }
+    ++stats.discards;
+    details::poolFree(Block);
+}
+
+inline void BSerializer::BufferPool::Collect() {
+    void* b;
+    {
+        std::lock_guard<std::mutex> guard(shared->lock);
+        b = shared->remote.exchange(nullptr, std::memory_order_relaxed);
+        outstanding -= shared->remoteCount;
+        shared->remoteCount = 0;
+    }
+    while (b) {
+        void* next = *(void**)b;
+        Retain(b, Capacity(b));
+        b = next;
+    }
+}
+
+inline void BSerializer::BufferPool::Retain(void* Block, size_t Capacity) {
+    size_t c = details::poolClass(Capacity);
+    if (stats.retained + Capacity > limit) {
+        ++stats.discards;
+        details::poolFree(Block);
+        return;
+    }
+    *(void**)Block = lists[c];
+    lists[c] = Block;
+    stats.retained += Capacity;
+    if (stats.retained > stats.peakRetained) stats.peakRetained = stats.retained;
+}
+
+__forceinline size_t BSerializer::BufferPool::Capacity(const void* Block) {
+    return *(const size_t*)((const uint8_t*)Block - details::poolHeaderSize);
+}
+
+inline void BSerializer::BufferPool::Trim() {
+    if (shared->remote.load(std::memory_order_relaxed)) Collect();
+    for (void*& l : lists) {
+        while (void* b = l) {
+            l = *(void**)b;
+            details::poolFree(b);
+        }
+    }
+    stats.retained = 0;
+}
+
+inline void BSerializer::BufferPool::SetRetentionLimit(size_t RetentionLimit) {
+    limit = RetentionLimit;
+    for (size_t c = details::poolClassCount; c-- && stats.retained > limit; ) {
+        while (stats.retained > limit && lists[c]) {
+            void* b = lists[c];
+            lists[c] = *(void**)b;
+            stats.retained -= (size_t)1 << (c + details::poolMinimumClass);
+            details::poolFree(b);
+        }
+    }
+}
+
+__forceinline size_t BSerializer::BufferPool::RetentionLimit() const {
+    return limit;
+}
+
+__forceinline BSerializer::BufferPoolStatistics BSerializer::BufferPool::Statistics() const {
+    return stats;
+}
+
+__forceinline BSerializer::PooledBuffer::PooledBuffer()
+    : data(0) { }
+
+__forceinline BSerializer::PooledBuffer::PooledBuffer(size_t Size)
+    : data(BufferPool::Local().Acquire(Size)) { }
+
+__forceinline BSerializer::PooledBuffer::PooledBuffer(PooledBuffer&& Other)
+    : data(std::exchange(Other.data, nullptr)) { }
+
+__forceinline BSerializer::PooledBuffer& BSerializer::PooledBuffer::operator=(PooledBuffer&& Other) {
+    if (this != &Other) {
+        BufferPool::Local().Release(data);
+        data = std::exchange(Other.data, nullptr);
+    }
+    return *this;
+}
+
+__forceinline BSerializer::PooledBuffer::~PooledBuffer() {
+    BufferPool::Local().Release(data);
+}
+
+__forceinline void* BSerializer::PooledBuffer::Data() const {
+    return data;
+}
+
+__forceinline size_t BSerializer::PooledBuffer::Capacity() const {
+    return data ? BufferPool::Capacity(data) : 0;
+}
@@ -0,0 +1,275 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include "Serializer.h"
+
+namespace BSerializer {
+    /**
+     * @brief The reasons serialized data can be rejected by BSerializer::Validate and BSerializer::TryDeserialize.
+     */
+    enum class DeserializeError {
+        /**
+         * @brief The data is well-formed.
+         */
+        None,
+        /**
+         * @brief The data ends before a value does.
+         */
+        Truncated,
+        /**
+         * @brief A variant index is out of bounds for a variant without a std::monostate alternative, or a bool or optional flag is neither 0 nor 1.
+         */
+        BadTag,
+        /**
+         * @brief The length prefix of a collection claims more elements than the rest of the data could hold.
+         */
+        OversizedLength,
+        /**
+         * @brief The elements of the collections would exceed the budget of the innermost BSerializer::DeserializationContext of the calling thread.
+         */
+        OverBudget
+    };
+
+    namespace details {
+        template <typename _T>
+        consteval bool isValidatable();
+
+        template <std::endian _E, typename _T>
+        __forceinline DeserializeError validate(const uint8_t*& Data, const uint8_t* End, size_t& Charged) noexcept;
+
+        template <std::endian _E, typename _T>
+        __forceinline DeserializeError validateVariant(const uint8_t*& Data, const uint8_t* End, size_t& Charged) noexcept;
+
+        template <std::endian _E>
+        __forceinline bool readLength(const uint8_t*& Data, const uint8_t* End, size_t& Length) noexcept;
+    }
+
+    /**
+     * @brief Concept to check if serialized data of a type can be checked by BSerializer::Validate. A type conforms if it conforms to BSerializer::Serializable and neither it nor any type it contains conforms to BSerializer::BuiltInSerializable, whose encoding BSerializer cannot see.
+     * @tparam _T The type whose conformity is evaluated.
+     */
+    template <typename _T>
+    concept Validatable = Serializable<_T> && details::isValidatable<_T>();
+
+    /**
+     * @brief Returns a short description of an error.
+     * @param[in] Error The error to describe.
+     * @return A null-terminated description of the error.
+     */
+    __forceinline const char* DeserializeErrorMessage(DeserializeError Error) noexcept;
+
+    /**
+     * @brief Checks that serialized data holds a well-formed value, without deserializing it or allocating.
+     *
+     * If a BSerializer::DeserializationContext is active on the calling thread, the data is also checked against its end and its remaining budget, so that deserializing data that passes does not throw.
+     * @tparam _E The byte order of the serialized data.
+     * @tparam _T The type of the value. _T must conform to BSerializer::Validatable.
+     * @param[in] Data A pointer to the source of the serialized data.
+     * @param[in] End A pointer to the end of the serialized data.
+     * @param[out] Size Set to the size of the serialized value, if it is well-formed.
+     * @return BSerializer::DeserializeError::None if the data is well-formed; otherwise, the first error found.
+     */
+    template <std::endian _E, Validatable _T>
+    __forceinline DeserializeError Validate(const void* Data, const void* End, size_t& Size) noexcept;
+    /**
+     * @brief Checks that little-endian serialized data holds a well-formed value, without deserializing it or allocating.
+     * @tparam _T The type of the value. _T must conform to BSerializer::Validatable.
+     * @param[in] Data A pointer to the source of the serialized data.
+     * @param[in] End A pointer to the end of the serialized data.
+     * @param[out] Size Set to the size of the serialized value, if it is well-formed.
+     * @return BSerializer::DeserializeError::None if the data is well-formed; otherwise, the first error found.
+     */
+    template <Validatable _T>
+    __forceinline DeserializeError Validate(const void* Data, const void* End, size_t& Size) noexcept;
+
+    /**
+     * @brief Deserializes a value from untrusted data, reporting malformed data as an error code instead of an exception.
+     *
+     * The data is validated with BSerializer::Validate, then deserialized with BSerializer::Deserialize. Validation reads only length prefixes, flags and indices, and checks contiguous arithmetic collections with a single comparison.
+     * Allocation failure while deserializing is not reported, and terminates the program.
+     *
+     * Example:
+     * @code
+     * alignas(Message) uint8_t storage[sizeof(Message)];
+     * const void* p = packet.data();
+     * if (BSerializer::DeserializeError e = BSerializer::TryDeserialize(p, packet.data() + packet.size(), (Message*)storage); e != BSerializer::DeserializeError::None) {
+     *     Log(BSerializer::DeserializeErrorMessage(e));
+     * }
+     * @endcode
+     * @tparam _E The byte order of the serialized data.
+     * @tparam _T The type of the value deserialized. _T must conform to BSerializer::Validatable.
+     * @param[in,out] Data A pointer to the source of the serialized data. After a successful deserialization, the pointer will be adjusted by the size of the data read; otherwise, it is left unchanged.
+     * @param[in] End A pointer to the end of the serialized data.
+     * @param[out] Value A pointer to the location in memory in which the deserialized value will be placed. Nothing is placed there if an error is returned.
+     * @return BSerializer::DeserializeError::None if the value was deserialized; otherwise, the first error found.
+     */
+    template <std::endian _E, Validatable _T>
+    __forceinline DeserializeError TryDeserialize(const void*& Data, const void* End, _T* Value) noexcept;
+    /**
+     * @brief Deserializes a value from untrusted little-endian data, reporting malformed data as an error code instead of an exception.
+     * @tparam _T The type of the value deserialized. _T must conform to BSerializer::Validatable.
+     * @param[in,out] Data A pointer to the source of the serialized data. After a successful deserialization, the pointer will be adjusted by the size of the data read; otherwise, it is left unchanged.
+     * @param[in] End A pointer to the end of the serialized data.
+     * @param[out] Value A pointer to the location in memory in which the deserialized value will be placed. Nothing is placed there if an error is returned.
+     * @return BSerializer::DeserializeError::None if the value was deserialized; otherwise, the first error found.
+     */
+    template <Validatable _T>
+    __forceinline DeserializeError TryDeserialize(const void*& Data, const void* End, _T* Value) noexcept;
+}
+
+template <typename _T>
+consteval bool BSerializer::details::isValidatable() {
+    if constexpr (BuiltInSerializable<_T>) return false;
+    else if constexpr (SerializableCollection<_T>) return isValidatable<std::remove_cv_t<typename _T::value_type>>();
+    else if constexpr (SerializableStdPair<_T>) return isValidatable<std::remove_cv_t<typename _T::first_type>>() && isValidatable<std::remove_cv_t<typename _T::second_type>>();
+    else if constexpr (SerializableStdTuple<_T>) {
+        return []<size_t... _Indices>(std::index_sequence<_Indices...>) {
+            return (isValidatable<std::remove_cv_t<std::tuple_element_t<_Indices, _T>>>() && ...);
+        }(std::make_index_sequence<std::tuple_size_v<_T>>());
+    }
+    else if constexpr (SerializableStdArray<_T>) return isValidatable<typename _T::value_type>();
+    else if constexpr (SerializableStdOptional<_T>) return isValidatable<typename _T::value_type>();
+    else if constexpr (SerializableStdVariant<_T>) {
+        return []<size_t... _Indices>(std::index_sequence<_Indices...>) {
+            return (isValidatable<std::variant_alternative_t<_Indices, _T>>() && ...);
+        }(std::make_index_sequence<std::variant_size_v<_T>>());
+    }
+    else return true;
+}
+
+template <std::endian _E>
+__forceinline bool BSerializer::details::readLength(const uint8_t*& Data, const uint8_t* End, size_t& Length) noexcept {
+    if ((size_t)(End - Data) < sizeof(size_t)) return false;
+    memcpy(&Length, Data, sizeof(size_t));
+    Length = ToFromEndian<_E>(Length);
+    Data += sizeof(size_t);
+    return true;
+}
+
+template <std::endian _E, typename _T>
+__forceinline BSerializer::DeserializeError BSerializer::details::validate(const uint8_t*& Data, const uint8_t* End, size_t& Charged) noexcept {
+    if constexpr (SerializableCollection<_T>) {
+        using value_t = std::remove_cv_t<typename _T::value_type>;
+        size_t len;
+        if (!readLength<_E>(Data, End, len)) return DeserializeError::Truncated;
+        size_t remaining = End - Data;
+        if constexpr (std::same_as<value_t, bool>) {
+            if ((len >> 3) + ((len & 7) ? 1 : 0) > remaining) return DeserializeError::OversizedLength;
+        }
+        else if constexpr (minimumSerializedSize<value_t>() != 0) {
+            if (len > remaining / minimumSerializedSize<value_t>()) return DeserializeError::OversizedLength;
+        }
+        if (const deserializationState* s = deserializationContext) {
+            if (!fitsBudget<value_t>(*s, len, Charged)) return DeserializeError::OverBudget;
+            Charged += sizeof(value_t) * len;
+        }
+        if constexpr (std::same_as<value_t, bool>) Data += (len >> 3) + ((len & 7) ? 1 : 0);
+        else if constexpr (Arithmetic<value_t>) Data += sizeof(value_t) * len;
+        else if constexpr (minimumSerializedSize<value_t>() != 0) {
+            for (size_t i = 0; i < len; ++i) {
+                if (DeserializeError e = validate<_E, value_t>(Data, End, Charged); e != DeserializeError::None) return e;
+            }
+        }
+        return DeserializeError::None;
+    }
+    else if constexpr (std::same_as<_T, bool>) {
+        if (Data == End) return DeserializeError::Truncated;
+        if (*Data > 1) return DeserializeError::BadTag;
+        ++Data;
+        return DeserializeError::None;
+    }
+    else if constexpr (Arithmetic<_T> || StdComplex<_T> || StdDuration<_T> || StdTimePoint<_T>) {
+        if ((size_t)(End - Data) < minimumSerializedSize<_T>()) return DeserializeError::Truncated;
+        Data += minimumSerializedSize<_T>();
+        return DeserializeError::None;
+    }
+    else if constexpr (SerializableStdPair<_T>) {
+        if (DeserializeError e = validate<_E, std::remove_cv_t<typename _T::first_type>>(Data, End, Charged); e != DeserializeError::None) return e;
+        return validate<_E, std::remove_cv_t<typename _T::second_type>>(Data, End, Charged);
+    }
+    else if constexpr (SerializableStdTuple<_T>) {
+        DeserializeError e = DeserializeError::None;
+        [&]<size_t... _Indices>(std::index_sequence<_Indices...>) {
+            (void)(((e = validate<_E, std::remove_cv_t<std::tuple_element_t<_Indices, _T>>>(Data, End, Charged)) == DeserializeError::None) && ...);
+        }(std::make_index_sequence<std::tuple_size_v<_T>>());
+        return e;
+    }
+    else if constexpr (SerializableStdArray<_T>) {
+        using value_t = typename _T::value_type;
+        if constexpr (Arithmetic<value_t> && !std::same_as<value_t, bool>) {
+            if ((size_t)(End - Data) < sizeof(_T)) return DeserializeError::Truncated;
+            Data += sizeof(_T);
+        }
+        else for (size_t i = 0; i < std::tuple_size_v<_T>; ++i) {
+            if (DeserializeError e = validate<_E, value_t>(Data, End, Charged); e != DeserializeError::None) return e;
+        }
+        return DeserializeError::None;
+    }
+    else if constexpr (SerializableStdOptional<_T>) {
+        if (Data == End) return DeserializeError::Truncated;
+        if (*Data > 1) return DeserializeError::BadTag;
+        if (!*Data++) return DeserializeError::None;
+        return validate<_E, typename _T::value_type>(Data, End, Charged);
+    }
+    else if constexpr (SerializableStdVariant<_T>) {
+        return validateVariant<_E, _T>(Data, End, Charged);
+    }
+    else return DeserializeError::None;
+}
+
+template <std::endian _E, typename _T>
+__forceinline BSerializer::DeserializeError BSerializer::details::validateVariant(const uint8_t*& Data, const uint8_t* End, size_t& Charged) noexcept {
+    size_t idx;
+    if (!readLength<_E>(Data, End, idx)) return DeserializeError::Truncated;
+    if (idx >= std::variant_size_v<_T>) {
+        if constexpr (variantHasMonostate<_T>) return DeserializeError::None;
+        else return DeserializeError::BadTag;
+    }
+    return [idx, &Data, End, &Charged]<size_t... _Indices>(std::index_sequence<_Indices...>) {
+        constexpr DeserializeError (*table[])(const uint8_t*&, const uint8_t*, size_t&) noexcept = { &validate<_E, std::variant_alternative_t<_Indices, _T>>... };
+        return table[idx](Data, End, Charged);
+    }(std::make_index_sequence<std::variant_size_v<_T>>());
+}
+
+__forceinline const char* BSerializer::DeserializeErrorMessage(DeserializeError Error) noexcept {
+    switch (Error) {
+    case DeserializeError::None: return "The data is well-formed.";
+    case DeserializeError::Truncated: return "The data ends before the value does.";
+    case DeserializeError::BadTag: return "A variant index, bool or optional flag is out of range.";
+    case DeserializeError::OversizedLength: return "A collection length exceeds what the remaining data could hold.";
+    case DeserializeError::OverBudget: return "The collections exceed the deserialization budget.";
+    }
+    return "Unknown error.";
+}
+
+template <std::endian _E, BSerializer::Validatable _T>
+__forceinline BSerializer::DeserializeError BSerializer::Validate(const void* Data, const void* End, size_t& Size) noexcept {
+    const uint8_t* p = (const uint8_t*)Data;
+    const uint8_t* end = (const uint8_t*)End;
+    if (const details::deserializationState* s = details::deserializationContext) {
+        if (s->end < end) end = s->end;
+    }
+    size_t charged = 0;
+    DeserializeError e = details::validate<_E, _T>(p, end, charged);
+    if (e == DeserializeError::None) Size = p - (const uint8_t*)Data;
+    return e;
+}
+
+template <BSerializer::Validatable _T>
+__forceinline BSerializer::DeserializeError BSerializer::Validate(const void* Data, const void* End, size_t& Size) noexcept {
+    return Validate<std::endian::little, _T>(Data, End, Size);
+}
+
+template <std::endian _E, BSerializer::Validatable _T>
+__forceinline BSerializer::DeserializeError BSerializer::TryDeserialize(const void*& Data, const void* End, _T* Value) noexcept {
+    size_t size;
+    if (DeserializeError e = Validate<_E, _T>(Data, End, size); e != DeserializeError::None) return e;
+    Deserialize<_E>(Data, Value);
+    return DeserializeError::None;
+}
+
+template <BSerializer::Validatable _T>
+__forceinline BSerializer::DeserializeError BSerializer::TryDeserialize(const void*& Data, const void* End, _T* Value) noexcept {
+    return TryDeserialize<std::endian::little, _T>(Data, End, Value);
+}
@@ -0,0 +1,452 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include "Serializer.h"
+
+namespace BSerializer {
+    /**
+     * @brief The outcome of a call to BSerializer::ChunkedSerializer::Serialize.
+     */
+    enum class ChunkResult {
+        /**
+         * @brief The value has been serialized in its entirety.
+         */
+        Complete,
+        /**
+         * @brief The buffer was filled before the value was fully serialized. Call BSerializer::ChunkedSerializer::Serialize again with another buffer.
+         */
+        NeedsMoreSpace
+    };
+
+    namespace details {
+        struct chunkState {
+            uint8_t* cur = 0;
+            uint8_t* end = 0;
+            const uint8_t* pending = 0;
+            size_t pendingSize = 0;
+            std::coroutine_handle<> resumePoint;
+            std::coroutine_handle<> next;
+
+            __forceinline bool Put(const void* Bytes, size_t Size);
+        };
+
+        struct chunkTask {
+            struct promise_type;
+            using handle_t = std::coroutine_handle<promise_type>;
+
+            struct finalAwaiter {
+                __forceinline bool await_ready() noexcept;
+                __forceinline void await_suspend(handle_t Handle) noexcept;
+                __forceinline void await_resume() noexcept;
+            };
+
+            struct promise_type {
+                chunkState& state;
+                std::coroutine_handle<> continuation;
+                std::exception_ptr exception;
+
+                template <typename... _Ts>
+                __forceinline promise_type(chunkState& State, const _Ts&... Args) noexcept;
+
+                __forceinline chunkTask get_return_object() noexcept;
+                __forceinline std::suspend_always initial_suspend() noexcept;
+                __forceinline finalAwaiter final_suspend() noexcept;
+                __forceinline void return_void() noexcept;
+                __forceinline void unhandled_exception() noexcept;
+            };
+
+            handle_t handle;
+
+            __forceinline explicit chunkTask(handle_t Handle) noexcept;
+            __forceinline chunkTask(chunkTask&& Other) noexcept;
+            chunkTask(const chunkTask&) = delete;
+            chunkTask& operator=(const chunkTask&) = delete;
+            __forceinline ~chunkTask();
+
+            __forceinline bool await_ready() noexcept;
+            __forceinline void await_suspend(std::coroutine_handle<> Parent) noexcept;
+            __forceinline void await_resume();
+        };
+
+        struct chunkWriter {
+            chunkState& state;
+            const void* bytes;
+            size_t size;
+
+            __forceinline bool await_ready();
+            __forceinline void await_suspend(std::coroutine_handle<> Handle) noexcept;
+            __forceinline void await_resume() noexcept;
+        };
+
+        template <typename _T>
+        struct chunkScalarWriter {
+            chunkState& state;
+            _T value;
+
+            __forceinline bool await_ready();
+            __forceinline void await_suspend(std::coroutine_handle<> Handle) noexcept;
+            __forceinline void await_resume() noexcept;
+        };
+
+        template <std::endian _E, Serializable _T>
+        chunkTask serializeChunked(chunkState& State, const _T& Value);
+
+        template <std::endian _E, Serializable _T>
+        __forceinline auto serializeChunkedElement(chunkState& State, const _T& Value);
+
+        constexpr size_t chunkInlineSize = 256;
+        constexpr size_t chunkInlineNone = (size_t)0 - (size_t)1;
+
+        template <std::endian _E, Serializable _T>
+        __forceinline size_t serializeChunkedInline(chunkState& State, const _T& Value, uint8_t* Buffer);
+
+        template <std::endian _E, size_t... _Indices, typename _TTuple>
+        chunkTask serializeChunkedTuple(chunkState& State, const _TTuple& Tuple, std::index_sequence<_Indices...>);
+
+        template <std::endian _E, size_t _Index, typename _TVariant>
+        chunkTask serializeChunkedVariantAlternative(chunkState& State, const _TVariant& Variant);
+
+        template <std::endian _E, typename _TVariant>
+        chunkTask serializeChunkedVariantNone(chunkState& State, const _TVariant& Variant);
+
+        template <std::endian _E, size_t... _Indices, typename _TVariant>
+        chunkTask serializeChunkedVariant(chunkState& State, const _TVariant& Variant, std::index_sequence<_Indices...>);
+    }
+
+    /**
+     * @brief Serializes a value into a sequence of caller-provided buffers of any size, without ever building the full serialized output.
+     *
+     * Each call to Serialize fills as much of the given buffer as possible, splitting scalars across buffer boundaries where necessary, and resumes where the previous call stopped.
+     * The concatenation of all the bytes written is identical to the output of BSerializer::Serialize with the same byte order.
+     * Memory use is proportional to the nesting depth of the value's type, not to the size of the value. Elements of collections and arrays that serialize to at most 256 bytes are serialized synchronously, directly into the buffer when they fit and through a fixed staging area otherwise, so that no coroutine frame is allocated per element. The one exception is a BuiltInSerializable type, which is serialized into a temporary buffer of its serialized size before being emitted.
+     * The value must outlive the ChunkedSerializer and must not be modified until serialization is complete.
+     *
+     * Example:
+     * @code
+     * BSerializer::ChunkedSerializer serializer(value);
+     * uint8_t buffer[4096];
+     * BSerializer::ChunkResult result;
+     * do {
+     *     void* p = buffer;
+     *     result = serializer.Serialize(p, sizeof(buffer));
+     *     send(buffer, (uint8_t*)p - buffer);
+     * } while (result == BSerializer::ChunkResult::NeedsMoreSpace);
+     * @endcode
+     */
+    class ChunkedSerializer final {
+    public:
+        /**
+         * @brief Prepares a value for chunked serialization. No data is written until Serialize is called.
+         * @tparam _T The type of the value serialized. _T must conform to BSerializer::Serializable.
+         * @param[in] Value The value to serialize. It must outlive the ChunkedSerializer and remain unmodified until serialization is complete.
+         */
+        template <Serializable _T>
+        ChunkedSerializer(const _T& Value);
+        /**
+         * @brief Prepares a value for chunked serialization with the given byte order. No data is written until Serialize is called.
+         * @tparam _T The type of the value serialized. _T must conform to BSerializer::Serializable.
+         * @tparam _E The byte order of the serialized data.
+         * @param[in] Value The value to serialize. It must outlive the ChunkedSerializer and remain unmodified until serialization is complete.
+         * @param[in] Endian A tag selecting the byte order, such as `BSerializer::EndianTag<std::endian::native>()`.
+         */
+        template <Serializable _T, std::endian _E>
+        ChunkedSerializer(const _T& Value, EndianTag<_E> Endian);
+        ChunkedSerializer(const ChunkedSerializer&) = delete;
+        ChunkedSerializer& operator=(const ChunkedSerializer&) = delete;
+
+        /**
+         * @brief Serializes as much of the value as fits in the buffer, continuing from where the previous call stopped.
+         * @param[in,out] Data A pointer to the destination buffer. After serialization, the pointer will be adjusted by the size of the data written.
+         * @param[in] Size The quantity of bytes available at Data.
+         * @return BSerializer::ChunkResult::Complete if the value has been fully serialized, or BSerializer::ChunkResult::NeedsMoreSpace if another call is required.
+         */
+        inline ChunkResult Serialize(void*& Data, size_t Size);
+        /**
+         * @brief Returns whether the value has been serialized in its entirety.
+         * @return Whether the value has been serialized in its entirety.
+         */
+        __forceinline bool IsComplete() const;
+    private:
+        details::chunkState state;
+        details::chunkTask root;
+    };
+}
+
+__forceinline bool BSerializer::details::chunkState::Put(const void* Bytes, size_t Size) {
+    size_t space = end - cur;
+    if (Size <= space) {
+        memcpy(cur, Bytes, Size);
+        cur += Size;
+        return true;
+    }
+    memcpy(cur, Bytes, space);
+    cur = end;
+    pending = (const uint8_t*)Bytes + space;
+    pendingSize = Size - space;
+    return false;
+}
+
+__forceinline bool BSerializer::details::chunkTask::finalAwaiter::await_ready() noexcept {
+    return false;
+}
+
+__forceinline void BSerializer::details::chunkTask::finalAwaiter::await_suspend(handle_t Handle) noexcept {
+    Handle.promise().state.next = Handle.promise().continuation;
+}
+
+__forceinline void BSerializer::details::chunkTask::finalAwaiter::await_resume() noexcept { }
+
+template <typename... _Ts>
+__forceinline BSerializer::details::chunkTask::promise_type::promise_type(chunkState& State, const _Ts&...) noexcept
+    : state(State) { }
+
+__forceinline BSerializer::details::chunkTask BSerializer::details::chunkTask::promise_type::get_return_object() noexcept {
+    return chunkTask(handle_t::from_promise(*this));
+}
+
+__forceinline std::suspend_always BSerializer::details::chunkTask::promise_type::initial_suspend() noexcept {
+    return { };
+}
+
+__forceinline BSerializer::details::chunkTask::finalAwaiter BSerializer::details::chunkTask::promise_type::final_suspend() noexcept {
+    return { };
+}
+
+__forceinline void BSerializer::details::chunkTask::promise_type::return_void() noexcept { }
+
+__forceinline void BSerializer::details::chunkTask::promise_type::unhandled_exception() noexcept {
+    exception = std::current_exception();
+}
+
+__forceinline BSerializer::details::chunkTask::chunkTask(handle_t Handle) noexcept
+    : handle(Handle) { }
+
+__forceinline BSerializer::details::chunkTask::chunkTask(chunkTask&& Other) noexcept
+    : handle(std::exchange(Other.handle, nullptr)) { }
+
+__forceinline BSerializer::details::chunkTask::~chunkTask() {
+    if (handle) handle.destroy();
+}
+
+__forceinline bool BSerializer::details::chunkTask::await_ready() noexcept {
+    return false;
+}
+
+__forceinline void BSerializer::details::chunkTask::await_suspend(std::coroutine_handle<> Parent) noexcept {
+    handle.promise().continuation = Parent;
+    handle.promise().state.next = handle;
+}
+
+__forceinline void BSerializer::details::chunkTask::await_resume() {
+    if (handle.promise().exception) std::rethrow_exception(handle.promise().exception);
+}
+
+__forceinline bool BSerializer::details::chunkWriter::await_ready() {
+    return state.Put(bytes, size);
+}
+
+__forceinline void BSerializer::details::chunkWriter::await_suspend(std::coroutine_handle<> Handle) noexcept {
+    state.resumePoint = Handle;
+    state.next = nullptr;
+}
+
+__forceinline void BSerializer::details::chunkWriter::await_resume() noexcept { }
+
+template <typename _T>
+__forceinline bool BSerializer::details::chunkScalarWriter<_T>::await_ready() {
+    return state.Put(&value, sizeof(_T));
+}
+
+template <typename _T>
+__forceinline void BSerializer::details::chunkScalarWriter<_T>::await_suspend(std::coroutine_handle<> Handle) noexcept {
+    state.resumePoint = Handle;
+    state.next = nullptr;
+}
+
+template <typename _T>
+__forceinline void BSerializer::details::chunkScalarWriter<_T>::await_resume() noexcept { }
+
+template <std::endian _E, BSerializer::Serializable _T>
+__forceinline auto BSerializer::details::serializeChunkedElement(chunkState& State, const _T& Value) {
+    if constexpr (Arithmetic<_T> && !BuiltInSerializable<_T>) {
+        return chunkScalarWriter<_T>{ State, ToFromEndian<_E>(Value) };
+    }
+    else {
+        return serializeChunked<_E>(State, Value);
+    }
+}
+
+template <std::endian _E, BSerializer::Serializable _T>
+__forceinline size_t BSerializer::details::serializeChunkedInline(chunkState& State, const _T& Value, uint8_t* Buffer) {
+    size_t size = SerializedSize(Value);
+    if (size <= (size_t)(State.end - State.cur)) {
+        void* data = State.cur;
+        Serialize<_E>(data, Value);
+        State.cur = (uint8_t*)data;
+        return 0;
+    }
+    if (size > chunkInlineSize) return chunkInlineNone;
+    void* data = Buffer;
+    Serialize<_E>(data, Value);
+    return size;
+}
+
+template <std::endian _E, size_t... _Indices, typename _TTuple>
+BSerializer::details::chunkTask BSerializer::details::serializeChunkedTuple(chunkState& State, const _TTuple& Tuple, std::index_sequence<_Indices...>) {
+    (co_await serializeChunkedElement<_E>(State, std::get<_Indices>(Tuple)), ...);
+}
+
+template <std::endian _E, size_t _Index, typename _TVariant>
+BSerializer::details::chunkTask BSerializer::details::serializeChunkedVariantAlternative(chunkState& State, const _TVariant& Variant) {
+    using element_t = std::variant_alternative_t<_Index, _TVariant>;
+    co_await chunkScalarWriter<size_t>{ State, ToFromEndian<_E>(_Index) };
+    if constexpr (!std::same_as<element_t, std::monostate>) {
+        co_await serializeChunkedElement<_E>(State, std::get<_Index>(Variant));
+    }
+}
+
+template <std::endian _E, typename _TVariant>
+BSerializer::details::chunkTask BSerializer::details::serializeChunkedVariantNone(chunkState& State, const _TVariant& Variant) {
+    co_await chunkScalarWriter<size_t>{ State, ToFromEndian<_E>((size_t)0 - (size_t)1) };
+}
+
+template <std::endian _E, size_t... _Indices, typename _TVariant>
+BSerializer::details::chunkTask BSerializer::details::serializeChunkedVariant(chunkState& State, const _TVariant& Variant, std::index_sequence<_Indices...>) {
+    using alternative_t = chunkTask(*)(chunkState&, const _TVariant&);
+    constexpr alternative_t alternatives[] = { &serializeChunkedVariantAlternative<_E, _Indices, _TVariant>... };
+    size_t idx = Variant.index();
+    if (idx < sizeof...(_Indices)) return alternatives[idx](State, Variant);
+    if constexpr ((std::same_as<std::monostate, std::variant_alternative_t<_Indices, _TVariant>> || ...)) {
+        return serializeChunkedVariantNone<_E>(State, Variant);
+    }
+    else throwOutOfRange("Index of 'std::variant<...>' is out of bounds; parameter 'Variant' is invalid.");
+}
+
+template <std::endian _E, BSerializer::Serializable _T>
+BSerializer::details::chunkTask BSerializer::details::serializeChunked(chunkState& State, const _T& Value) {
+    if constexpr (BuiltInSerializable<_T>) {
+        size_t size = Value.SerializedSize();
+        std::unique_ptr<uint8_t[]> bytes(new uint8_t[size]);
+        void* data = bytes.get();
+        Value.Serialize(data);
+        co_await chunkWriter{ State, bytes.get(), size };
+    }
+    else if constexpr (SerializableCollection<_T>) {
+        using value_t = typename _T::value_type;
+        size_t len = Value.size();
+        co_await chunkScalarWriter<size_t>{ State, ToFromEndian<_E>(len) };
+        if (len) {
+            if constexpr (std::same_as<value_t, bool>) {
+                uint64_t m = 1;
+                uint64_t c = 0;
+                for (auto i = Value.cbegin(); i != Value.cend(); ++i) {
+                    if (!m) {
+                        co_await chunkScalarWriter<uint64_t>{ State, ToFromLittleEndian(c) };
+                        m = 1;
+                        c = 0;
+                    }
+                    if (*i) c |= m;
+                    m <<= 1;
+                }
+                if (m) {
+                    size_t i = ((len & 63) + 7) >> 3;
+                    c = ToFromLittleEndian(c);
+                    co_await chunkWriter{ State, &c, i };
+                }
+                else co_await chunkScalarWriter<uint64_t>{ State, ToFromLittleEndian(c) };
+            }
+            else if constexpr (Arithmetic<value_t> && std::contiguous_iterator<typename _T::const_iterator> && _E == std::endian::native) {
+                co_await chunkWriter{ State, std::to_address(Value.cbegin()), sizeof(value_t) * len };
+            }
+            else {
+                uint8_t buffer[chunkInlineSize];
+                for (auto& v : Value) {
+                    size_t staged = serializeChunkedInline<_E>(State, v, buffer);
+                    if (staged == chunkInlineNone) co_await serializeChunked<_E>(State, v);
+                    else if (staged) co_await chunkWriter{ State, buffer, staged };
+                }
+            }
+        }
+    }
+    else if constexpr (Arithmetic<_T>) {
+        co_await chunkScalarWriter<_T>{ State, ToFromEndian<_E>(Value) };
+    }
+    else if constexpr (SerializableStdPair<_T>) {
+        co_await serializeChunkedElement<_E>(State, Value.first);
+        co_await serializeChunkedElement<_E>(State, Value.second);
+    }
+    else if constexpr (SerializableStdTuple<_T>) {
+        co_await serializeChunkedTuple<_E>(State, Value, std::make_index_sequence<std::tuple_size_v<_T>>());
+    }
+    else if constexpr (StdComplex<_T>) {
+        co_await serializeChunkedElement<_E>(State, Value.real());
+        co_await serializeChunkedElement<_E>(State, Value.imag());
+    }
+    else if constexpr (SerializableStdArray<_T>) {
+        using value_t = typename _T::value_type;
+        if constexpr (Arithmetic<value_t> && !std::same_as<value_t, bool> && _E == std::endian::native) {
+            co_await chunkWriter{ State, Value.data(), sizeof(_T) };
+        }
+        else {
+            uint8_t buffer[chunkInlineSize];
+            for (auto& e : Value) {
+                size_t staged = serializeChunkedInline<_E>(State, e, buffer);
+                if (staged == chunkInlineNone) co_await serializeChunked<_E>(State, e);
+                else if (staged) co_await chunkWriter{ State, buffer, staged };
+            }
+        }
+    }
+    else if constexpr (SerializableStdOptional<_T>) {
+        if (Value) {
+            co_await chunkScalarWriter<bool>{ State, true };
+            co_await serializeChunkedElement<_E>(State, *Value);
+        }
+        else co_await chunkScalarWriter<bool>{ State, false };
+    }
+    else if constexpr (SerializableStdVariant<_T>) {
+        co_await serializeChunkedVariant<_E>(State, Value, std::make_index_sequence<std::variant_size_v<_T>>());
+    }
+    else if constexpr (StdDuration<_T>) {
+        co_await serializeChunkedElement<_E>(State, Value.count());
+    }
+    else if constexpr (StdTimePoint<_T>) {
+        co_await serializeChunkedElement<_E>(State, Value.time_since_epoch().count());
+    }
+}
+
+template <BSerializer::Serializable _T>
+BSerializer::ChunkedSerializer::ChunkedSerializer(const _T& Value)
+    : ChunkedSerializer(Value, EndianTag<std::endian::little>()) { }
+
+template <BSerializer::Serializable _T, std::endian _E>
+BSerializer::ChunkedSerializer::ChunkedSerializer(const _T& Value, EndianTag<_E>)
+    : root(details::serializeChunked<_E>(state, Value)) {
+    state.resumePoint = root.handle;
+}
+
+inline BSerializer::ChunkResult BSerializer::ChunkedSerializer::Serialize(void*& Data, size_t Size) {
+    state.cur = (uint8_t*)Data;
+    state.end = state.cur + Size;
+    if (state.pendingSize) {
+        const uint8_t* pending = state.pending;
+        size_t pendingSize = state.pendingSize;
+        state.pendingSize = 0;
+        if (!state.Put(pending, pendingSize)) {
+            Data = state.cur;
+            return ChunkResult::NeedsMoreSpace;
+        }
+    }
+    if (!root.handle.done()) {
+        state.next = state.resumePoint;
+        while (state.next) std::exchange(state.next, nullptr).resume();
+    }
+    Data = state.cur;
+    if (root.handle.promise().exception) std::rethrow_exception(root.handle.promise().exception);
+    return root.handle.done() ? ChunkResult::Complete : ChunkResult::NeedsMoreSpace;
+}
+
+__forceinline bool BSerializer::ChunkedSerializer::IsComplete() const {
+    return root.handle.done() && !state.pendingSize;
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include "Serializable.h"
+
+namespace BSerializer {
+    namespace details {
+        struct deserializationState {
+            const uint8_t* end;
+            size_t budget;
+            size_t used;
+        };
+
+        inline thread_local deserializationState* deserializationContext = 0;
+
+        template <typename _T>
+        consteval size_t minimumSerializedSize();
+
+        template <typename _T>
+        __forceinline bool fitsBudget(const deserializationState& State, size_t Length, size_t Pending);
+
+        template <typename _T>
+        __forceinline void chargeCollection(const void* Data, size_t Length);
+
+        [[noreturn]] inline void throwLengthError(const char* Message);
+    }
+
+    /**
+     * @brief Bounds the memory that BSerializer::Deserialize may allocate for collections on the calling thread, for decoding untrusted data. Contexts may be nested; the innermost one applies.
+     *
+     * Before the elements of any collection are allocated, including those of nested collections, the length prefix is checked against the input that remains before the end of the data, at the smallest size an element can be serialized in, and against the budget that remains.
+     * If either check fails, std::length_error is thrown before anything is allocated. The budget counts the element storage of each collection, sizeof(value_type) times its length; it does not count the per-node overhead of node-based containers.
+     *
+     * Example:
+     * @code
+     * BSerializer::DeserializationContext context(packet.data() + packet.size(), 1 << 20);
+     * const void* p = packet.data();
+     * Message m = BSerializer::Deserialize<Message>(p);
+     * @endcode
+     */
+    class DeserializationContext final {
+    public:
+        /**
+         * @brief Makes a context the innermost one of the calling thread.
+         * @param[in] End A pointer to the end of the serialized data.
+         * @param[in] Budget The maximum quantity of bytes of collection elements that may be allocated while the context is active.
+         */
+        __forceinline DeserializationContext(const void* End, size_t Budget);
+        DeserializationContext(const DeserializationContext&) = delete;
+        DeserializationContext& operator=(const DeserializationContext&) = delete;
+        __forceinline ~DeserializationContext();
+
+        /**
+         * @brief Returns the quantity of bytes charged against the budget so far.
+         * @return The quantity of bytes charged against the budget so far.
+         */
+        __forceinline size_t Used() const;
+        /**
+         * @brief Returns the quantity of bytes that may still be charged against the budget.
+         * @return The quantity of bytes that may still be charged against the budget.
+         */
+        __forceinline size_t Remaining() const;
+        /**
+         * @brief Returns a pointer to the end of the serialized data.
+         * @return A pointer to the end of the serialized data.
+         */
+        __forceinline const void* End() const;
+    private:
+        details::deserializationState state;
+        details::deserializationState* previous;
+    };
+}
+
+template <typename _T>
+consteval size_t BSerializer::details::minimumSerializedSize() {
+    if constexpr (SerializableCollection<_T>) return sizeof(size_t);
+    else if constexpr (Arithmetic<_T>) return sizeof(_T);
+    else if constexpr (SerializableStdPair<_T>) return minimumSerializedSize<std::remove_cv_t<typename _T::first_type>>() + minimumSerializedSize<std::remove_cv_t<typename _T::second_type>>();
+    else if constexpr (SerializableStdTuple<_T>) {
+        return []<size_t... _Indices>(std::index_sequence<_Indices...>) {
+            return (minimumSerializedSize<std::remove_cv_t<std::tuple_element_t<_Indices, _T>>>() + ... + 0);
+        }(std::make_index_sequence<std::tuple_size_v<_T>>());
+    }
+    else if constexpr (StdComplex<_T>) return sizeof(decltype(std::declval<_T>().real())) << 1;
+    else if constexpr (SerializableStdArray<_T>) return minimumSerializedSize<typename _T::value_type>() * std::tuple_size_v<_T>;
+    else if constexpr (SerializableStdOptional<_T>) return sizeof(bool);
+    else if constexpr (SerializableStdVariant<_T>) return sizeof(size_t);
+    else if constexpr (StdDuration<_T>) return sizeof(decltype(std::declval<_T>().count()));
+    else if constexpr (StdTimePoint<_T>) return sizeof(decltype(std::declval<_T>().time_since_epoch().count()));
+    else return 0;
+}
+
+template <typename _T>
+__forceinline bool BSerializer::details::fitsBudget(const deserializationState& State, size_t Length, size_t Pending) {
+    return Length <= (State.budget - State.used - Pending) / sizeof(_T);
+}
+
+template <typename _T>
+__forceinline void BSerializer::details::chargeCollection(const void* Data, size_t Length) {
+    deserializationState* s = deserializationContext;
+    if (!s) return;
+    const uint8_t* p = (const uint8_t*)Data;
+    if (p > s->end) throwLengthError("The serialized data ends before the length of a collection.");
+    size_t remaining = s->end - p;
+    if constexpr (std::same_as<_T, bool>) {
+        if ((Length >> 3) + ((Length & 7) ? 1 : 0) > remaining) throwLengthError("The length of a collection exceeds what the remaining data could hold.");
+    }
+    else if constexpr (minimumSerializedSize<_T>() != 0) {
+        if (Length > remaining / minimumSerializedSize<_T>()) throwLengthError("The length of a collection exceeds what the remaining data could hold.");
+    }
+    if (!fitsBudget<_T>(*s, Length, 0)) throwLengthError("The length of a collection exceeds the deserialization budget.");
+    s->used += sizeof(_T) * Length;
+}
+
+inline void BSerializer::details::throwLengthError(const char* Message) {
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+    throw std::length_error(Message);
+#else
+    (void)Message;
+    std::abort();
+#endif
+}
+
+__forceinline BSerializer::DeserializationContext::DeserializationContext(const void* End, size_t Budget)
+    : state{ (const uint8_t*)End, Budget, 0 }, previous(details::deserializationContext) {
+    details::deserializationContext = &state;
+}
+
+__forceinline BSerializer::DeserializationContext::~DeserializationContext() {
+    details::deserializationContext = previous;
+}
+
+__forceinline size_t BSerializer::DeserializationContext::Used() const {
+    return state.used;
+}
+
+__forceinline size_t BSerializer::DeserializationContext::Remaining() const {
+    return state.budget - state.used;
+}
+
+__forceinline const void* BSerializer::DeserializationContext::End() const {
+    return state.end;
+}
@@ -0,0 +1,271 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "Serializer.h"
+
+#if __has_include(<sys/uio.h>)
+#include <sys/uio.h>
+#endif
+
+namespace BSerializer {
+#if __has_include(<sys/uio.h>)
+    /**
+     * @brief A reference to a contiguous range of serialized bytes. On POSIX systems this is `iovec`, so an array of segments can be passed directly to `writev` or `sendmsg`.
+     */
+    using GatherSegment = iovec;
+#else
+    /**
+     * @brief A reference to a contiguous range of serialized bytes, laid out like POSIX `iovec`.
+     */
+    struct GatherSegment {
+        void* iov_base;
+        size_t iov_len;
+    };
+#endif
+
+    class GatherSerializer;
+
+    namespace details {
+        template <std::endian _E, Serializable _T>
+        void gatherSerialize(GatherSerializer& Serializer, const _T& Value);
+    }
+
+    /**
+     * @brief Serializes values into a gather list instead of a single contiguous buffer.
+     *
+     * Small fields and headers are written into staging blocks owned by the GatherSerializer. When the byte order of the serialized data matches that of the architecture, contiguous collections and arrays of arithmetic values whose size reaches the reference threshold are not copied; instead, a segment referencing the source memory is emitted.
+     * The concatenation of all segments is identical to the output of BSerializer::Serialize with the same byte order.
+     * Referenced values must outlive the use of the segments and must not be modified in the meantime. Note that `writev` accepts at most `IOV_MAX` segments per call.
+     *
+     * Example:
+     * @code
+     * BSerializer::GatherSerializer gather;
+     * gather.Serialize(header);
+     * gather.Serialize(samples);
+     * writev(fd, gather.Segments(), (int)gather.SegmentCount());
+     * @endcode
+     */
+    class GatherSerializer final {
+        template <std::endian _E, Serializable _T>
+        friend void details::gatherSerialize(GatherSerializer& Serializer, const _T& Value);
+    public:
+        /**
+         * @brief Creates an empty gather list.
+         * @param[in] ReferenceThreshold The minimum size, in bytes, of an arithmetic range for it to be referenced rather than copied.
+         * @param[in] BlockSize The size, in bytes, of each staging block.
+         */
+        inline GatherSerializer(size_t ReferenceThreshold = 1024, size_t BlockSize = 4096);
+        GatherSerializer(const GatherSerializer&) = delete;
+        GatherSerializer& operator=(const GatherSerializer&) = delete;
+
+        /**
+         * @brief Appends a serialized value to the gather list.
+         * @tparam _T The type of the value serialized. _T must conform to BSerializer::Serializable.
+         * @param[in] Value The value to serialize. Parts of it may be referenced rather than copied.
+         */
+        template <Serializable _T>
+        __forceinline void Serialize(const _T& Value);
+        /**
+         * @brief Appends a value serialized with the given byte order to the gather list.
+         * @tparam _E The byte order of the serialized data. std::endian::native performs no conversion, and is appropriate only when both ends share an architecture.
+         * @tparam _T The type of the value serialized. _T must conform to BSerializer::Serializable.
+         * @param[in] Value The value to serialize. Parts of it may be referenced rather than copied.
+         */
+        template <std::endian _E, Serializable _T>
+        __forceinline void Serialize(const _T& Value);
+        /**
+         * @brief Appends a copy of raw data to the gather list.
+         * @param[in] Data A pointer to the data.
+         * @param[in] Size The size of the data, in bytes.
+         */
+        inline void SerializeRaw(const void* Data, size_t Size);
+        /**
+         * @brief Appends raw data to the gather list by reference, without copying it.
+         * @param[in] Data A pointer to the data.
+         * @param[in] Size The size of the data, in bytes.
+         */
+        inline void SerializeRawReference(const void* Data, size_t Size);
+
+        /**
+         * @brief Returns the segments of the gather list.
+         * @return A pointer to the first of SegmentCount() segments.
+         */
+        __forceinline const GatherSegment* Segments() const;
+        /**
+         * @brief Returns the segments of the gather list for modification, for example to advance past the data accepted by a partial `writev`. The data the segments reference must not be modified.
+         * @return A pointer to the first of SegmentCount() segments.
+         */
+        __forceinline GatherSegment* Segments();
+        /**
+         * @brief Returns the quantity of segments in the gather list.
+         * @return The quantity of segments in the gather list.
+         */
+        __forceinline size_t SegmentCount() const;
+        /**
+         * @brief Returns the total size of the serialized data, in bytes.
+         * @return The sum of the sizes of all segments.
+         */
+        __forceinline size_t Size() const;
+        /**
+         * @brief Empties the gather list so that it may be reused. The first staging block is retained.
+         */
+        inline void Clear();
+    private:
+        size_t referenceThreshold;
+        size_t blockSize;
+        std::vector<std::unique_ptr<uint8_t[]>> blocks;
+        uint8_t* blockCur;
+        uint8_t* blockEnd;
+        std::vector<GatherSegment> segments;
+        size_t size;
+
+        inline void* Reserve(size_t Size);
+        __forceinline void Append(const void* Data, size_t Size);
+    };
+}
+
+inline BSerializer::GatherSerializer::GatherSerializer(size_t ReferenceThreshold, size_t BlockSize)
+    : referenceThreshold(ReferenceThreshold), blockSize(BlockSize), blockCur(0), blockEnd(0), size(0) { }
+
+template <BSerializer::Serializable _T>
+__forceinline void BSerializer::GatherSerializer::Serialize(const _T& Value) {
+    details::gatherSerialize<std::endian::little>(*this, Value);
+}
+
+template <std::endian _E, BSerializer::Serializable _T>
+__forceinline void BSerializer::GatherSerializer::Serialize(const _T& Value) {
+    details::gatherSerialize<_E>(*this, Value);
+}
+
+inline void BSerializer::GatherSerializer::SerializeRaw(const void* Data, size_t Size) {
+    if (!Size) return;
+    Append(Data, Size);
+}
+
+inline void BSerializer::GatherSerializer::SerializeRawReference(const void* Data, size_t Size) {
+    if (!Size) return;
+    segments.push_back(GatherSegment{ const_cast<void*>(Data), Size });
+    size += Size;
+}
+
+__forceinline const BSerializer::GatherSegment* BSerializer::GatherSerializer::Segments() const {
+    return segments.data();
+}
+
+__forceinline BSerializer::GatherSegment* BSerializer::GatherSerializer::Segments() {
+    return segments.data();
+}
+
+__forceinline size_t BSerializer::GatherSerializer::SegmentCount() const {
+    return segments.size();
+}
+
+__forceinline size_t BSerializer::GatherSerializer::Size() const {
+    return size;
+}
+
+inline void BSerializer::GatherSerializer::Clear() {
+    if (blocks.size() > 1) blocks.resize(1);
+    if (blocks.empty()) blockCur = blockEnd = 0;
+    else {
+        blockCur = blocks[0].get();
+        blockEnd = blockCur + blockSize;
+    }
+    segments.clear();
+    size = 0;
+}
+
+inline void* BSerializer::GatherSerializer::Reserve(size_t Size) {
+    if ((size_t)(blockEnd - blockCur) < Size) {
+        size_t s = Size > blockSize ? Size : blockSize;
+        blocks.emplace_back(new uint8_t[s]);
+        blockCur = blocks.back().get();
+        blockEnd = blockCur + s;
+    }
+    uint8_t* p = blockCur;
+    blockCur += Size;
+    size += Size;
+    if (!segments.empty() && (uint8_t*)segments.back().iov_base + segments.back().iov_len == p) {
+        segments.back().iov_len += Size;
+    }
+    else segments.push_back(GatherSegment{ p, Size });
+    return p;
+}
+
+__forceinline void BSerializer::GatherSerializer::Append(const void* Data, size_t Size) {
+    memcpy(Reserve(Size), Data, Size);
+}
+
+template <std::endian _E, BSerializer::Serializable _T>
+void BSerializer::details::gatherSerialize(GatherSerializer& Serializer, const _T& Value) {
+    if constexpr (SerializableCollection<_T> && !BuiltInSerializable<_T>) {
+        using value_t = typename _T::value_type;
+        if constexpr (Arithmetic<value_t> && !std::same_as<value_t, bool> && std::contiguous_iterator<typename _T::const_iterator> && _E == std::endian::native) {
+            size_t len = Value.size();
+            size_t s = sizeof(value_t) * len;
+            if (s >= Serializer.referenceThreshold) {
+                size_t v = ToFromEndian<_E>(len);
+                Serializer.Append(&v, sizeof(size_t));
+                Serializer.SerializeRawReference(std::to_address(Value.cbegin()), s);
+                return;
+            }
+        }
+        if constexpr (Arithmetic<value_t>) {
+            void* p = Serializer.Reserve(SerializedSize(Value));
+            BSerializer::Serialize<_E>(p, Value);
+        }
+        else {
+            size_t v = ToFromEndian<_E>((size_t)Value.size());
+            Serializer.Append(&v, sizeof(size_t));
+            for (auto& e : Value) gatherSerialize<_E>(Serializer, e);
+        }
+    }
+    else if constexpr (SerializableStdArray<_T> && !BuiltInSerializable<_T>) {
+        using value_t = typename _T::value_type;
+        if constexpr (Arithmetic<value_t>) {
+            if constexpr (!std::same_as<value_t, bool> && _E == std::endian::native) {
+                if (sizeof(_T) >= Serializer.referenceThreshold) {
+                    Serializer.SerializeRawReference(Value.data(), sizeof(_T));
+                    return;
+                }
+            }
+            void* p = Serializer.Reserve(SerializedSize(Value));
+            BSerializer::Serialize<_E>(p, Value);
+        }
+        else for (auto& e : Value) gatherSerialize<_E>(Serializer, e);
+    }
+    else if constexpr (SerializableStdPair<_T> && !BuiltInSerializable<_T>) {
+        gatherSerialize<_E>(Serializer, Value.first);
+        gatherSerialize<_E>(Serializer, Value.second);
+    }
+    else if constexpr (SerializableStdTuple<_T> && !BuiltInSerializable<_T>) {
+        std::apply([&Serializer](const auto&... args) {
+            (gatherSerialize<_E>(Serializer, args), ...);
+        }, Value);
+    }
+    else if constexpr (SerializableStdOptional<_T> && !BuiltInSerializable<_T>) {
+        bool v = (bool)Value;
+        Serializer.Append(&v, sizeof(bool));
+        if (Value) gatherSerialize<_E>(Serializer, *Value);
+    }
+    else if constexpr (SerializableStdVariant<_T> && !BuiltInSerializable<_T>) {
+        if (Value.valueless_by_exception()) {
+            void* p = Serializer.Reserve(SerializedSize(Value));
+            BSerializer::Serialize<_E>(p, Value);
+        }
+        else {
+            size_t v = ToFromEndian<_E>((size_t)Value.index());
+            Serializer.Append(&v, sizeof(size_t));
+            std::visit([&Serializer](const auto& Alternative) {
+                if constexpr (!std::same_as<std::remove_cvref_t<decltype(Alternative)>, std::monostate>) {
+                    gatherSerialize<_E>(Serializer, Alternative);
+                }
+            }, Value);
+        }
+    }
+    else {
+        void* p = Serializer.Reserve(SerializedSize(Value));
+        BSerializer::Serialize<_E>(p, Value);
+    }
+}
@@ -0,0 +1,350 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "TypeName.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#ifdef BSERIALIZER_INSTRUMENT
+#define BSERIALIZER_INSTRUMENT_SCOPE(Type, Operation, ...) BSerializer::details::instrumentScope<Type> bserializerInstrumentScope(BSerializer::InstrumentedOperation::Operation __VA_OPT__(,) __VA_ARGS__)
+#else
+#define BSERIALIZER_INSTRUMENT_SCOPE(Type, Operation, ...) ((void)0)
+#endif
+
+namespace BSerializer {
+    /**
+     * @brief The entry points of BSerializer that are instrumented when BSERIALIZER_INSTRUMENT is defined.
+     */
+    enum class InstrumentedOperation {
+        SerializedSize,
+        Serialize,
+        Deserialize
+    };
+
+    /**
+     * @brief The quantity of buckets in an instrumentation latency histogram. Bucket i counts calls that took fewer than 2^i cycles, and at least 2^(i-1).
+     */
+    constexpr size_t InstrumentationBuckets = 48;
+
+    /**
+     * @brief The aggregated counters of one operation on one type.
+     */
+    struct InstrumentationEntry final {
+        /**
+         * @brief The name of the type, as returned by BSerializer::TypeName.
+         */
+        std::string type;
+        /**
+         * @brief The instrumented operation.
+         */
+        InstrumentedOperation operation;
+        /**
+         * @brief The quantity of calls.
+         */
+        uint64_t calls;
+        /**
+         * @brief The quantity of bytes written or read. Always zero for BSerializer::InstrumentedOperation::SerializedSize.
+         */
+        uint64_t bytes;
+        /**
+         * @brief The total cycles spent in the calls, as counted by the time-stamp counter, or nanoseconds where no such counter exists.
+         */
+        uint64_t cycles;
+        /**
+         * @brief The latency histogram of the calls, in cycles, with logarithmic buckets.
+         */
+        uint64_t histogram[InstrumentationBuckets];
+    };
+
+    /**
+     * @brief Aggregates the counters of every thread, including threads that have exited.
+     *
+     * Only outermost calls are counted: the cost of serializing a nested value is attributed to the type passed to BSerializer by the caller.
+     * Nothing is recorded unless BSERIALIZER_INSTRUMENT is defined before BSerializer is included; without it, the instrumentation compiles to nothing.
+     * @return One entry for each operation and type that has been called at least once, ordered by descending cycles.
+     */
+    inline std::vector<InstrumentationEntry> InstrumentationSnapshot();
+    /**
+     * @brief Zeroes the counters of every thread.
+     */
+    inline void ResetInstrumentation();
+    /**
+     * @brief Formats a snapshot as a human-readable table.
+     * @param[in] Entries The snapshot to format.
+     * @return A line per entry, with its calls, bytes, total and mean cycles, and approximate median and 99th percentile latency.
+     */
+    inline std::string DumpInstrumentation(const std::vector<InstrumentationEntry>& Entries = InstrumentationSnapshot());
+    /**
+     * @brief Formats a snapshot as JSON.
+     * @param[in] Entries The snapshot to format.
+     * @return A JSON array with an object per entry, including its full histogram.
+     */
+    inline std::string DumpInstrumentationJson(const std::vector<InstrumentationEntry>& Entries = InstrumentationSnapshot());
+
+    namespace details {
+        constexpr size_t instrumentOperations = 3;
+
+        struct instrumentSlot {
+            std::atomic<uint64_t> calls;
+            std::atomic<uint64_t> bytes;
+            std::atomic<uint64_t> cycles;
+            std::atomic<uint64_t> histogram[InstrumentationBuckets];
+        };
+
+        struct instrumentThread {
+            std::vector<std::unique_ptr<instrumentSlot>> slots;
+
+            inline instrumentThread();
+            inline ~instrumentThread();
+
+            inline instrumentSlot& Slot(size_t Index);
+        };
+
+        struct instrumentRegistry {
+            std::mutex mutex;
+            std::vector<std::string> names;
+            std::vector<instrumentThread*> threads;
+            std::vector<std::unique_ptr<instrumentSlot>> retired;
+        };
+
+        inline instrumentRegistry& registry();
+
+        inline thread_local size_t instrumentDepth = 0;
+
+        __forceinline uint64_t readCycles();
+
+        inline size_t registerType(std::string_view Name);
+
+        template <typename _T>
+        inline const size_t typeIndex = registerType(TypeName<_T>());
+
+        inline void record(size_t Type, InstrumentedOperation Operation, uint64_t Bytes, uint64_t Cycles);
+
+        inline void appendSlot(std::vector<std::unique_ptr<instrumentSlot>>& Slots, size_t Index, const instrumentSlot& Slot);
+
+        inline const char* operationName(InstrumentedOperation Operation);
+
+        inline uint64_t histogramPercentile(const InstrumentationEntry& Entry, double Fraction);
+
+        template <typename _T>
+        class instrumentScope final {
+        public:
+            __forceinline explicit instrumentScope(InstrumentedOperation Operation);
+            template <typename _TPtr>
+            __forceinline instrumentScope(InstrumentedOperation Operation, _TPtr* const& Data);
+            __forceinline ~instrumentScope();
+            instrumentScope(const instrumentScope&) = delete;
+            instrumentScope& operator=(const instrumentScope&) = delete;
+        private:
+            InstrumentedOperation operation;
+            const void* const* data;
+            const void* begin;
+            uint64_t start;
+            bool outer;
+        };
+    }
+}
+
+inline BSerializer::details::instrumentThread::instrumentThread() {
+    instrumentRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.threads.push_back(this);
+}
+
+inline BSerializer::details::instrumentThread::~instrumentThread() {
+    instrumentRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (size_t i = 0; i < slots.size(); ++i) if (slots[i]) appendSlot(r.retired, i, *slots[i]);
+    r.threads.erase(std::find(r.threads.begin(), r.threads.end(), this));
+}
+
+inline BSerializer::details::instrumentSlot& BSerializer::details::instrumentThread::Slot(size_t Index) {
+    if (Index >= slots.size() || !slots[Index]) {
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        if (Index >= slots.size()) slots.resize(Index + 1);
+        slots[Index].reset(new instrumentSlot());
+    }
+    return *slots[Index];
+}
+
+inline BSerializer::details::instrumentRegistry& BSerializer::details::registry() {
+    static instrumentRegistry r;
+    return r;
+}
+
+__forceinline uint64_t BSerializer::details::readCycles() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+inline size_t BSerializer::details::registerType(std::string_view Name) {
+    instrumentRegistry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.names.emplace_back(Name);
+    return r.names.size() - 1;
+}
+
+inline void BSerializer::details::record(size_t Type, InstrumentedOperation Operation, uint64_t Bytes, uint64_t Cycles) {
+    static thread_local instrumentThread thread;
+    instrumentSlot& s = thread.Slot(Type * instrumentOperations + (size_t)Operation);
+    size_t b = std::min((size_t)std::bit_width(Cycles), InstrumentationBuckets - 1);
+    s.calls.store(s.calls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    s.bytes.store(s.bytes.load(std::memory_order_relaxed) + Bytes, std::memory_order_relaxed);
+    s.cycles.store(s.cycles.load(std::memory_order_relaxed) + Cycles, std::memory_order_relaxed);
+    s.histogram[b].store(s.histogram[b].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+inline void BSerializer::details::appendSlot(std::vector<std::unique_ptr<instrumentSlot>>& Slots, size_t Index, const instrumentSlot& Slot) {
+    if (Index >= Slots.size()) Slots.resize(Index + 1);
+    if (!Slots[Index]) Slots[Index].reset(new instrumentSlot());
+    instrumentSlot& d = *Slots[Index];
+    d.calls.fetch_add(Slot.calls.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    d.bytes.fetch_add(Slot.bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    d.cycles.fetch_add(Slot.cycles.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    for (size_t i = 0; i < InstrumentationBuckets; ++i) d.histogram[i].fetch_add(Slot.histogram[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+template <typename _T>
+__forceinline BSerializer::details::instrumentScope<_T>::instrumentScope(InstrumentedOperation Operation)
+    : operation(Operation), data(0), begin(0), start(0), outer(!instrumentDepth++) {
+    if (outer) start = readCycles();
+}
+
+template <typename _T>
+template <typename _TPtr>
+__forceinline BSerializer::details::instrumentScope<_T>::instrumentScope(InstrumentedOperation Operation, _TPtr* const& Data)
+    : operation(Operation), data((const void* const*)&Data), begin(Data), start(0), outer(!instrumentDepth++) {
+    if (outer) start = readCycles();
+}
+
+template <typename _T>
+__forceinline BSerializer::details::instrumentScope<_T>::~instrumentScope() {
+    --instrumentDepth;
+    if (outer) {
+        uint64_t c = readCycles() - start;
+        record(typeIndex<_T>, operation, data ? (uint64_t)((const uint8_t*)*data - (const uint8_t*)begin) : 0, c);
+    }
+}
+
+inline std::vector<BSerializer::InstrumentationEntry> BSerializer::InstrumentationSnapshot() {
+    details::instrumentRegistry& r = details::registry();
+    std::vector<std::unique_ptr<details::instrumentSlot>> total;
+    std::vector<std::string> names;
+    {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (size_t i = 0; i < r.retired.size(); ++i) if (r.retired[i]) details::appendSlot(total, i, *r.retired[i]);
+        for (details::instrumentThread* t : r.threads) {
+            for (size_t i = 0; i < t->slots.size(); ++i) if (t->slots[i]) details::appendSlot(total, i, *t->slots[i]);
+        }
+        names = r.names;
+    }
+    std::vector<InstrumentationEntry> entries;
+    for (size_t i = 0; i < total.size(); ++i) {
+        if (!total[i] || !total[i]->calls.load(std::memory_order_relaxed)) continue;
+        InstrumentationEntry e;
+        e.type = names[i / details::instrumentOperations];
+        e.operation = (InstrumentedOperation)(i % details::instrumentOperations);
+        e.calls = total[i]->calls.load(std::memory_order_relaxed);
+        e.bytes = total[i]->bytes.load(std::memory_order_relaxed);
+        e.cycles = total[i]->cycles.load(std::memory_order_relaxed);
+        for (size_t j = 0; j < InstrumentationBuckets; ++j) e.histogram[j] = total[i]->histogram[j].load(std::memory_order_relaxed);
+        entries.push_back(std::move(e));
+    }
+    std::sort(entries.begin(), entries.end(), [](const InstrumentationEntry& A, const InstrumentationEntry& B) {
+        return A.cycles > B.cycles;
+    });
+    return entries;
+}
+
+inline void BSerializer::ResetInstrumentation() {
+    details::instrumentRegistry& r = details::registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.retired.clear();
+    for (details::instrumentThread* t : r.threads) {
+        for (std::unique_ptr<details::instrumentSlot>& s : t->slots) {
+            if (!s) continue;
+            s->calls.store(0, std::memory_order_relaxed);
+            s->bytes.store(0, std::memory_order_relaxed);
+            s->cycles.store(0, std::memory_order_relaxed);
+            for (std::atomic<uint64_t>& h : s->histogram) h.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+inline const char* BSerializer::details::operationName(InstrumentedOperation Operation) {
+    switch (Operation) {
+    case InstrumentedOperation::SerializedSize: return "SerializedSize";
+    case InstrumentedOperation::Serialize: return "Serialize";
+    default: return "Deserialize";
+    }
+}
+
+inline uint64_t BSerializer::details::histogramPercentile(const InstrumentationEntry& Entry, double Fraction) {
+    uint64_t target = (uint64_t)(Entry.calls * Fraction);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < InstrumentationBuckets; ++i) {
+        seen += Entry.histogram[i];
+        if (seen > target) return (uint64_t)1 << i;
+    }
+    return (uint64_t)1 << (InstrumentationBuckets - 1);
+}
+
+inline std::string BSerializer::DumpInstrumentation(const std::vector<InstrumentationEntry>& Entries) {
+    std::string s;
+    for (const InstrumentationEntry& e : Entries) {
+        s += details::operationName(e.operation);
+        s += ' ';
+        s += e.type;
+        s += ": calls=" + std::to_string(e.calls);
+        s += " bytes=" + std::to_string(e.bytes);
+        s += " cycles=" + std::to_string(e.cycles);
+        s += " mean=" + std::to_string(e.calls ? e.cycles / e.calls : 0);
+        s += " p50<" + std::to_string(details::histogramPercentile(e, 0.5));
+        s += " p99<" + std::to_string(details::histogramPercentile(e, 0.99));
+        s += '\n';
+    }
+    return s;
+}
+
+inline std::string BSerializer::DumpInstrumentationJson(const std::vector<InstrumentationEntry>& Entries) {
+    std::string s = "[";
+    for (const InstrumentationEntry& e : Entries) {
+        if (s.size() > 1) s += ',';
+        s += "{\"type\":\"";
+        for (char c : e.type) {
+            if (c == '"' || c == '\\') s += '\\';
+            s += c;
+        }
+        s += "\",\"operation\":\"";
+        s += details::operationName(e.operation);
+        s += "\",\"calls\":" + std::to_string(e.calls);
+        s += ",\"bytes\":" + std::to_string(e.bytes);
+        s += ",\"cycles\":" + std::to_string(e.cycles);
+        s += ",\"histogram\":[";
+        size_t n = InstrumentationBuckets;
+        while (n && !e.histogram[n - 1]) --n;
+        for (size_t i = 0; i < n; ++i) {
+            if (i) s += ',';
+            s += std::to_string(e.histogram[i]);
+        }
+        s += "]}";
+    }
+    s += ']';
+    return s;
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include "Serializer.h"
+
+#if __has_include(<unistd.h>)
+#include <cerrno>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace BSerializer {
+    namespace details {
+        constexpr size_t hugePageSize = 2 << 20;
+
+        __forceinline size_t pageSize();
+    }
+
+    /**
+     * @brief Selects whether a BSerializer::PageBuffer is backed by huge pages, which reduce TLB misses when serializing very large values.
+     */
+    enum class HugePages {
+        /**
+         * @brief The buffer is backed by pages of the default size.
+         */
+        None,
+        /**
+         * @brief The buffer is advised with `madvise(MADV_HUGEPAGE)`, so that the kernel backs it with transparent huge pages where it can.
+         */
+        Transparent,
+        /**
+         * @brief The buffer is mapped with `MAP_HUGETLB` from the reserved huge page pool. If the pool cannot satisfy the request, transparent huge pages are used instead.
+         */
+        Explicit
+    };
+
+    /**
+     * @brief An anonymous, page-aligned region of memory, mapped with `mmap`. Its alignment satisfies the requirements of `O_DIRECT` and `vmsplice`.
+     */
+    class PageBuffer final {
+    public:
+        /**
+         * @brief Creates an object that owns no memory.
+         */
+        __forceinline PageBuffer();
+        /**
+         * @brief Maps a region of at least the given size, rounded up to a whole quantity of pages.
+         * @param[in] Size The minimum size of the region, in bytes.
+         * @param[in] Pages The kind of pages backing the region. For huge pages, the size is rounded up to a whole quantity of huge pages.
+         */
+        inline explicit PageBuffer(size_t Size, HugePages Pages = HugePages::None);
+        __forceinline PageBuffer(PageBuffer&& Other);
+        __forceinline PageBuffer& operator=(PageBuffer&& Other);
+        PageBuffer(const PageBuffer&) = delete;
+        PageBuffer& operator=(const PageBuffer&) = delete;
+        inline ~PageBuffer();
+
+        /**
+         * @brief Returns a pointer to the region.
+         * @return A pointer to the region, aligned to the page size.
+         */
+        __forceinline void* Data() const;
+        /**
+         * @brief Returns the size of the region, in bytes.
+         * @return The size of the region, a multiple of the page size.
+         */
+        __forceinline size_t Capacity() const;
+    private:
+        void* data;
+        size_t capacity;
+    };
+}
+
+__forceinline size_t BSerializer::details::pageSize() {
+    static const size_t size = (size_t)sysconf(_SC_PAGESIZE);
+    return size;
+}
+
+__forceinline BSerializer::PageBuffer::PageBuffer()
+    : data(0), capacity(0) { }
+
+inline BSerializer::PageBuffer::PageBuffer(size_t Size, HugePages Pages) {
+    size_t page = Pages == HugePages::None ? details::pageSize() : details::hugePageSize;
+    capacity = Size ? (Size + page - 1) & ~(page - 1) : page;
+    data = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    if (Pages == HugePages::Explicit) data = mmap(0, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+    if (data == MAP_FAILED) {
+        data = mmap(0, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (data == MAP_FAILED) throw std::system_error(errno, std::system_category(), "mmap");
+#ifdef MADV_HUGEPAGE
+        if (Pages != HugePages::None) madvise(data, capacity, MADV_HUGEPAGE);
+#endif
+    }
+}
+
+__forceinline BSerializer::PageBuffer::PageBuffer(PageBuffer&& Other)
+    : data(std::exchange(Other.data, nullptr)), capacity(std::exchange(Other.capacity, 0)) { }
+
+__forceinline BSerializer::PageBuffer& BSerializer::PageBuffer::operator=(PageBuffer&& Other) {
+    if (this != &Other) {
+        if (data) munmap(data, capacity);
+        data = std::exchange(Other.data, nullptr);
+        capacity = std::exchange(Other.capacity, 0);
+    }
+    return *this;
+}
+
+inline BSerializer::PageBuffer::~PageBuffer() {
+    if (data) munmap(data, capacity);
+}
+
+__forceinline void* BSerializer::PageBuffer::Data() const {
+    return data;
+}
+
+__forceinline size_t BSerializer::PageBuffer::Capacity() const {
+    return capacity;
+}
+#endif
@@ -0,0 +1,360 @@
+#pragma once
+
+#include <bit>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Serializer.h"
+
+namespace BSerializer {
+    /**
+     * @brief The statistics recorded at one position in the structure of a type.
+     */
+    struct PayloadShapeNode final {
+        /**
+         * @brief The quantity of collections observed at the position, bucketed by the bit width of their length: bucket 0 counts empty collections, and bucket i counts lengths in [2^(i-1), 2^i).
+         */
+        std::vector<uint64_t> lengths;
+        /**
+         * @brief The quantity of variants observed at the position, by index of the held alternative.
+         */
+        std::vector<uint64_t> alternatives;
+        /**
+         * @brief The quantity of engaged optionals observed at the position.
+         */
+        uint64_t present;
+        /**
+         * @brief The quantity of disengaged optionals observed at the position.
+         */
+        uint64_t absent;
+    };
+
+    /**
+     * @brief Statistics of the shape of a population of values: the distributions of collection lengths, variant alternatives and optional engagement at each position in their type.
+     *
+     * A shape recorded from production values contains no content, only counts, and can itself be serialized with BSerializer and shipped elsewhere. There, BSerializer::PayloadShape::Generate produces deterministic synthetic values with the same statistics, and BSerializer::BenchmarkShape times BSerializer on them.
+     *
+     * Example:
+     * @code
+     * BSerializer::PayloadShape shape;
+     * for (const Message& m : traffic) shape.Record(m);
+     * BSerializer::ShapeBenchmarkResult r = BSerializer::BenchmarkShape<Message>(shape, 10000);
+     * @endcode
+     */
+    class PayloadShape final {
+    public:
+        /**
+         * @brief Adds the shape of a value to the statistics.
+         * @tparam _T The type of the value. _T must conform to BSerializer::Serializable.
+         * @param[in] Value The value to record.
+         */
+        template <Serializable _T>
+        __forceinline void Record(const _T& Value);
+        /**
+         * @brief Generates a value whose shape is drawn from the statistics. Arithmetic content is pseudo-random.
+         *
+         * Positions with no recorded statistics produce empty collections, disengaged optionals and the first alternative of variants. Collections that discard duplicates, such as maps, may come out shorter than the length drawn. Types that conform to BSerializer::BuiltInSerializable are default-constructed.
+         * @tparam _T The type of the value. _T must conform to BSerializer::Serializable.
+         * @param[in] Seed The seed of the generator. Equal seeds and shapes produce equal values.
+         * @return The generated value.
+         */
+        template <Serializable _T>
+        __forceinline _T Generate(uint64_t Seed) const;
+
+        /**
+         * @brief Returns the statistics at each position, keyed by a path such as "/<1>/[]/first".
+         * @return The statistics at each position.
+         */
+        __forceinline const std::map<std::string, PayloadShapeNode>& Nodes() const;
+
+        __forceinline size_t SerializedSize() const;
+        __forceinline void Serialize(void*& Data) const;
+        static __forceinline PayloadShape Deserialize(const void*& Data);
+        static __forceinline void Deserialize(const void*& Data, void* Value);
+    private:
+        using node_t = std::tuple<std::vector<uint64_t>, std::vector<uint64_t>, uint64_t, uint64_t>;
+
+        std::map<std::string, PayloadShapeNode> nodes;
+
+        template <typename _T>
+        __forceinline void Record(const _T& Value, const std::string& Path);
+        template <typename _T>
+        __forceinline _T Generate(const std::string& Path, uint64_t& State) const;
+        __forceinline const PayloadShapeNode* Find(const std::string& Path) const;
+        __forceinline std::map<std::string, node_t> Flatten() const;
+    };
+
+    /**
+     * @brief The timings of BSerializer::BenchmarkShape.
+     */
+    struct ShapeBenchmarkResult final {
+        /**
+         * @brief The quantity of values generated.
+         */
+        size_t values;
+        /**
+         * @brief The total serialized size of the values, in bytes.
+         */
+        size_t bytes;
+        /**
+         * @brief The mean time to serialize all of the values once, in nanoseconds.
+         */
+        double serializeNanoseconds;
+        /**
+         * @brief The mean time to deserialize and destroy all of the values once, in nanoseconds.
+         */
+        double deserializeNanoseconds;
+    };
+
+    /**
+     * @brief Generates values from a shape, then times their serialization and deserialization.
+     * @tparam _T The type of the values. _T must conform to BSerializer::Serializable.
+     * @param[in] Shape The shape from which to generate values.
+     * @param[in] Count The quantity of values to generate.
+     * @param[in] Seed The seed of the first value; the others use consecutive seeds.
+     * @param[in] Iterations The quantity of timed passes over the values.
+     * @return The timings, averaged over the passes.
+     */
+    template <Serializable _T>
+    inline ShapeBenchmarkResult BenchmarkShape(const PayloadShape& Shape, size_t Count, uint64_t Seed = 0, size_t Iterations = 10);
+
+    namespace details {
+        __forceinline uint64_t shapeRandom(uint64_t& State);
+
+        __forceinline size_t shapeLength(const PayloadShapeNode* Node, uint64_t& State);
+
+        __forceinline size_t shapeAlternative(const PayloadShapeNode* Node, uint64_t& State);
+    }
+}
+
+template <BSerializer::Serializable _T>
+__forceinline void BSerializer::PayloadShape::Record(const _T& Value) {
+    Record<_T>(Value, std::string());
+}
+
+template <typename _T>
+__forceinline void BSerializer::PayloadShape::Record(const _T& Value, const std::string& Path) {
+    if constexpr (BuiltInSerializable<_T>) { }
+    else if constexpr (SerializableCollection<_T>) {
+        using value_t = typename _T::value_type;
+        PayloadShapeNode& n = nodes[Path];
+        if (n.lengths.empty()) n.lengths.resize(65);
+        ++n.lengths[std::bit_width(Value.size())];
+        if constexpr (!Arithmetic<value_t>) {
+            std::string p = Path + "/[]";
+            for (auto& v : Value) Record<value_t>(v, p);
+        }
+    }
+    else if constexpr (SerializableStdPair<_T>) {
+        Record<typename _T::first_type>(Value.first, Path + "/first");
+        Record<typename _T::second_type>(Value.second, Path + "/second");
+    }
+    else if constexpr (SerializableStdTuple<_T>) {
+        [&]<size_t... _Indices>(std::index_sequence<_Indices...>) {
+            (Record<std::tuple_element_t<_Indices, _T>>(std::get<_Indices>(Value), Path + "/<" + std::to_string(_Indices) + ">"), ...);
+        }(std::make_index_sequence<std::tuple_size_v<_T>>());
+    }
+    else if constexpr (SerializableStdArray<_T>) {
+        std::string p = Path + "/[]";
+        for (auto& v : Value) Record<typename _T::value_type>(v, p);
+    }
+    else if constexpr (SerializableStdOptional<_T>) {
+        PayloadShapeNode& n = nodes[Path];
+        if (Value) {
+            ++n.present;
+            Record<typename _T::value_type>(*Value, Path + "/value");
+        }
+        else ++n.absent;
+    }
+    else if constexpr (SerializableStdVariant<_T>) {
+        PayloadShapeNode& n = nodes[Path];
+        if (n.alternatives.size() < std::variant_size_v<_T>) n.alternatives.resize(std::variant_size_v<_T>);
+        ++n.alternatives[Value.index()];
+        std::visit([&](const auto& Alternative) {
+            using alternative_t = std::remove_cvref_t<decltype(Alternative)>;
+            if constexpr (!std::same_as<alternative_t, std::monostate>) Record<alternative_t>(Alternative, Path + "/<" + std::to_string(Value.index()) + ">");
+        }, Value);
+    }
+}
+
+template <BSerializer::Serializable _T>
+__forceinline _T BSerializer::PayloadShape::Generate(uint64_t Seed) const {
+    uint64_t state = Seed;
+    return Generate<_T>(std::string(), state);
+}
+
+template <typename _T>
+__forceinline _T BSerializer::PayloadShape::Generate(const std::string& Path, uint64_t& State) const {
+    if constexpr (BuiltInSerializable<_T> || std::same_as<_T, std::monostate>) {
+        return _T();
+    }
+    else if constexpr (SerializableCollection<_T>) {
+        using value_t = typename _T::value_type;
+        size_t len = details::shapeLength(Find(Path), State);
+        if constexpr (std::same_as<value_t, bool>) {
+            std::unique_ptr<bool[]> arr(new bool[len ? len : 1]);
+            for (size_t i = 0; i < len; ++i) arr[i] = details::shapeRandom(State) & 1;
+            return _T(arr.get(), arr.get() + len);
+        }
+        else {
+            std::string p = Path + "/[]";
+            std::vector<value_t> arr;
+            arr.reserve(len);
+            for (size_t i = 0; i < len; ++i) arr.emplace_back(Generate<value_t>(p, State));
+            return _T(arr.data(), arr.data() + len);
+        }
+    }
+    else if constexpr (Arithmetic<_T>) {
+        uint64_t r = details::shapeRandom(State);
+        if constexpr (std::same_as<_T, bool>) return (bool)(r & 1);
+        else if constexpr (std::floating_point<_T>) return (_T)((double)(r >> 11) * 0x1.0p-53);
+        else return (_T)r;
+    }
+    else if constexpr (SerializableStdPair<_T>) {
+        using t1_t = typename _T::first_type;
+        using t2_t = typename _T::second_type;
+        t1_t v1 = Generate<std::remove_cv_t<t1_t>>(Path + "/first", State);
+        return _T(std::move(v1), Generate<std::remove_cv_t<t2_t>>(Path + "/second", State));
+    }
+    else if constexpr (SerializableStdTuple<_T>) {
+        return [&]<size_t... _Indices>(std::index_sequence<_Indices...>) {
+            return _T{ Generate<std::tuple_element_t<_Indices, _T>>(Path + "/<" + std::to_string(_Indices) + ">", State)... };
+        }(std::make_index_sequence<std::tuple_size_v<_T>>());
+    }
+    else if constexpr (StdComplex<_T>) {
+        using component_t = decltype(std::declval<_T>().real());
+        component_t re = Generate<component_t>(Path, State);
+        return _T(re, Generate<component_t>(Path, State));
+    }
+    else if constexpr (SerializableStdArray<_T>) {
+        _T r;
+        std::string p = Path + "/[]";
+        for (auto& v : r) v = Generate<typename _T::value_type>(p, State);
+        return r;
+    }
+    else if constexpr (SerializableStdOptional<_T>) {
+        const PayloadShapeNode* n = Find(Path);
+        uint64_t total = n ? n->present + n->absent : 0;
+        if (total && details::shapeRandom(State) % total < n->present) return _T(Generate<typename _T::value_type>(Path + "/value", State));
+        return _T();
+    }
+    else if constexpr (SerializableStdVariant<_T>) {
+        size_t index = details::shapeAlternative(Find(Path), State);
+        if (index >= std::variant_size_v<_T>) index = 0;
+        _T r;
+        [&]<size_t... _Indices>(std::index_sequence<_Indices...>) {
+            ((index == _Indices ? (r.template emplace<_Indices>(Generate<std::variant_alternative_t<_Indices, _T>>(Path + "/<" + std::to_string(_Indices) + ">", State)), true) : false) || ...);
+        }(std::make_index_sequence<std::variant_size_v<_T>>());
+        return r;
+    }
+    else if constexpr (StdDuration<_T>) {
+        return _T(Generate<typename _T::rep>(Path, State));
+    }
+    else if constexpr (StdTimePoint<_T>) {
+        return _T(Generate<typename _T::duration>(Path, State));
+    }
+}
+
+__forceinline const BSerializer::PayloadShapeNode* BSerializer::PayloadShape::Find(const std::string& Path) const {
+    auto it = nodes.find(Path);
+    return it == nodes.end() ? 0 : &it->second;
+}
+
+__forceinline const std::map<std::string, BSerializer::PayloadShapeNode>& BSerializer::PayloadShape::Nodes() const {
+    return nodes;
+}
+
+__forceinline std::map<std::string, BSerializer::PayloadShape::node_t> BSerializer::PayloadShape::Flatten() const {
+    std::map<std::string, node_t> m;
+    for (auto& [path, n] : nodes) m.emplace(path, node_t(n.lengths, n.alternatives, n.present, n.absent));
+    return m;
+}
+
+__forceinline size_t BSerializer::PayloadShape::SerializedSize() const {
+    return BSerializer::SerializedSize(Flatten());
+}
+
+__forceinline void BSerializer::PayloadShape::Serialize(void*& Data) const {
+    BSerializer::Serialize(Data, Flatten());
+}
+
+__forceinline BSerializer::PayloadShape BSerializer::PayloadShape::Deserialize(const void*& Data) {
+    PayloadShape s;
+    for (auto& [path, n] : BSerializer::Deserialize<std::map<std::string, node_t>>(Data)) {
+        s.nodes.emplace(path, PayloadShapeNode{ std::get<0>(n), std::get<1>(n), std::get<2>(n), std::get<3>(n) });
+    }
+    return s;
+}
+
+__forceinline void BSerializer::PayloadShape::Deserialize(const void*& Data, void* Value) {
+    new (Value) PayloadShape(Deserialize(Data));
+}
+
+__forceinline uint64_t BSerializer::details::shapeRandom(uint64_t& State) {
+    uint64_t z = (State += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+__forceinline size_t BSerializer::details::shapeLength(const PayloadShapeNode* Node, uint64_t& State) {
+    if (!Node || Node->lengths.empty()) return 0;
+    uint64_t total = 0;
+    for (uint64_t c : Node->lengths) total += c;
+    if (!total) return 0;
+    uint64_t r = shapeRandom(State) % total;
+    size_t b = 0;
+    while (r >= Node->lengths[b]) r -= Node->lengths[b++];
+    if (!b) return 0;
+    size_t low = (size_t)1 << (b - 1);
+    return low + (size_t)(shapeRandom(State) % low);
+}
+
+__forceinline size_t BSerializer::details::shapeAlternative(const PayloadShapeNode* Node, uint64_t& State) {
+    if (!Node) return 0;
+    uint64_t total = 0;
+    for (uint64_t c : Node->alternatives) total += c;
+    if (!total) return 0;
+    uint64_t r = shapeRandom(State) % total;
+    size_t i = 0;
+    while (r >= Node->alternatives[i]) r -= Node->alternatives[i++];
+    return i;
+}
+
+template <BSerializer::Serializable _T>
+inline BSerializer::ShapeBenchmarkResult BSerializer::BenchmarkShape(const PayloadShape& Shape, size_t Count, uint64_t Seed, size_t Iterations) {
+    std::vector<_T> values;
+    values.reserve(Count);
+    size_t bytes = 0;
+    for (size_t i = 0; i < Count; ++i) {
+        values.push_back(Shape.Generate<_T>(Seed + i));
+        bytes += BSerializer::SerializedSize(values.back());
+    }
+    std::unique_ptr<uint8_t[]> buffer(new uint8_t[bytes ? bytes : 1]);
+    std::unique_ptr<uint8_t[]> scratch(new uint8_t[sizeof(_T) + alignof(_T)]);
+    _T* value = (_T*)(((uintptr_t)scratch.get() + alignof(_T) - 1) & ~(uintptr_t)(alignof(_T) - 1));
+    if (!Iterations) Iterations = 1;
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < Iterations; ++i) {
+        void* p = buffer.get();
+        for (const _T& v : values) BSerializer::Serialize(p, v);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < Iterations; ++i) {
+        const void* p = buffer.get();
+        for (size_t j = 0; j < Count; ++j) {
+            BSerializer::Deserialize<_T>(p, value);
+            value->~_T();
+        }
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    return {
+        Count,
+        bytes,
+        std::chrono::duration<double, std::nano>(t1 - t0).count() / Iterations,
+        std::chrono::duration<double, std::nano>(t2 - t1).count() / Iterations
+    };
+}
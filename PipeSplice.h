@@ -0,0 +1,275 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include "PageBuffer.h"
+#include "Serializer.h"
+
+#if __has_include(<unistd.h>)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace BSerializer {
+    namespace details {
+        __forceinline void writeAll(int Handle, const void* Data, size_t Size);
+    }
+
+    /**
+     * @brief Writes serialized buffers into a pipe. On Linux, whole pages are gifted to the pipe with `vmsplice`, so the serialized bytes are never copied into the kernel.
+     *
+     * A buffer submitted to the sink is consumed by it: the pages are released from this process's address space once they have been spliced, and the reader of the pipe receives the very same pages.
+     * If `vmsplice` is unavailable or refuses the pipe, the sink falls back to `write` for the remainder of its lifetime.
+     * Splicing pays off only once a message spans several pages; for messages of a page or less it performs like `write`. BSerializer::BenchmarkPipeSplice compares the two for a given message.
+     *
+     * Example:
+     * @code
+     * BSerializer::PipeSink sink(pipeFds[1]);
+     * sink.Send(batch);
+     * @endcode
+     */
+    class PipeSink final {
+    public:
+        /**
+         * @brief Attaches to the writing end of a pipe.
+         * @param[in] Handle The descriptor of the writing end. The sink does not take ownership of it.
+         * @param[in] UseVmsplice Whether to attempt `vmsplice`. If false, `write` is always used.
+         */
+        inline explicit PipeSink(int Handle, bool UseVmsplice = true);
+
+        /**
+         * @brief Writes the first Size bytes of a buffer to the pipe, blocking until all of them have been accepted.
+         * @param[in] Buffer The buffer to write. The sink takes ownership of it.
+         * @param[in] Size The quantity of bytes to write. Size must not exceed the capacity of the buffer.
+         */
+        inline void Submit(PageBuffer&& Buffer, size_t Size);
+        /**
+         * @brief Serializes a value into a fresh page-aligned buffer and submits it.
+         * @tparam _T The type of the value serialized. _T must conform to BSerializer::Serializable.
+         * @param[in] Value The value to serialize.
+         */
+        template <Serializable _T>
+        __forceinline void Send(const _T& Value);
+        /**
+         * @brief Returns whether the sink is currently writing with `vmsplice`.
+         * @return Whether the sink is currently writing with `vmsplice`. This becomes false if the kernel refuses it.
+         */
+        __forceinline bool IsSplicing() const;
+    private:
+        int handle;
+        bool splicing;
+    };
+
+    /**
+     * @brief Moves data out of a pipe into a file or socket. On Linux, `splice` is used, so the data is never copied through user space.
+     *
+     * If `splice` is unavailable or refuses either descriptor, the source falls back to `read` and `write` through an intermediate buffer for the remainder of its lifetime.
+     */
+    class PipeSource final {
+    public:
+        /**
+         * @brief Attaches to the reading end of a pipe.
+         * @param[in] Handle The descriptor of the reading end. The source does not take ownership of it.
+         * @param[in] UseSplice Whether to attempt `splice`. If false, `read` and `write` are always used.
+         */
+        inline explicit PipeSource(int Handle, bool UseSplice = true);
+
+        /**
+         * @brief Moves up to Size bytes from the pipe to another descriptor, blocking until they have been moved or the pipe is closed.
+         * @param[in] Destination The descriptor of the destination file or socket.
+         * @param[in] Size The maximum quantity of bytes to move.
+         * @return The quantity of bytes moved. This is less than Size only if the writing end of the pipe was closed.
+         */
+        inline size_t Transfer(int Destination, size_t Size);
+        /**
+         * @brief Returns whether the source is currently moving data with `splice`.
+         * @return Whether the source is currently moving data with `splice`. This becomes false if the kernel refuses it.
+         */
+        __forceinline bool IsSplicing() const;
+    private:
+        int handle;
+        bool splicing;
+        std::unique_ptr<uint8_t[]> bounce;
+    };
+
+    /**
+     * @brief The timings of BSerializer::BenchmarkPipeSplice.
+     */
+    struct PipeBenchmarkResult final {
+        /**
+         * @brief The total quantity of bytes moved through the pipe in each mode.
+         */
+        size_t bytes;
+        /**
+         * @brief The throughput with `write` into the pipe and `read` out of it, in bytes per second.
+         */
+        double copyBytesPerSecond;
+        /**
+         * @brief The throughput with `vmsplice` into the pipe and `splice` out of it, in bytes per second.
+         */
+        double spliceBytesPerSecond;
+        /**
+         * @brief Whether the kernel accepted `vmsplice` and `splice` throughout. If not, both timings measure copies.
+         */
+        bool spliced;
+    };
+
+    /**
+     * @brief Sends a value through a pipe Count times in each mode, serializing it into a fresh page-aligned buffer each time, and times the transfers to `/dev/null` on the other end.
+     *
+     * The copying mode uses a BSerializer::PipeSink and BSerializer::PipeSource with splicing disabled, and the splicing mode the same pair with splicing enabled, so the comparison includes the page-aligned allocation and serialization that both modes share.
+     * @tparam _T The type of the value. _T must conform to BSerializer::Serializable.
+     * @param[in] Value The value to send.
+     * @param[in] Count The quantity of times the value is sent in each mode.
+     * @return The timings of both modes.
+     */
+    template <Serializable _T>
+    inline PipeBenchmarkResult BenchmarkPipeSplice(const _T& Value, size_t Count = 256);
+}
+
+__forceinline void BSerializer::details::writeAll(int Handle, const void* Data, size_t Size) {
+    const uint8_t* p = (const uint8_t*)Data;
+    while (Size) {
+        ssize_t n = write(Handle, p, Size);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw std::system_error(errno, std::system_category(), "write");
+        }
+        p += n;
+        Size -= (size_t)n;
+    }
+}
+
+inline BSerializer::PipeSink::PipeSink(int Handle, bool UseVmsplice)
+    : handle(Handle) {
+#ifdef __linux__
+    splicing = UseVmsplice;
+#else
+    splicing = false;
+#endif
+}
+
+inline void BSerializer::PipeSink::Submit(PageBuffer&& Buffer, size_t Size) {
+    if (Size > Buffer.Capacity()) throw std::out_of_range("'Size' exceeds the capacity of 'Buffer'.");
+    PageBuffer buffer(std::move(Buffer));
+    const uint8_t* p = (const uint8_t*)buffer.Data();
+#ifdef __linux__
+    while (splicing && Size) {
+        iovec v = { const_cast<uint8_t*>(p), Size };
+        ssize_t n = vmsplice(handle, &v, 1, SPLICE_F_GIFT);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EINVAL || errno == ENOSYS) {
+                splicing = false;
+                break;
+            }
+            throw std::system_error(errno, std::system_category(), "vmsplice");
+        }
+        p += n;
+        Size -= (size_t)n;
+    }
+#endif
+    details::writeAll(handle, p, Size);
+}
+
+template <BSerializer::Serializable _T>
+__forceinline void BSerializer::PipeSink::Send(const _T& Value) {
+    size_t size = SerializedSize(Value);
+    PageBuffer buffer(size);
+    void* p = buffer.Data();
+    BSerializer::Serialize(p, Value);
+    Submit(std::move(buffer), size);
+}
+
+__forceinline bool BSerializer::PipeSink::IsSplicing() const {
+    return splicing;
+}
+
+inline BSerializer::PipeSource::PipeSource(int Handle, bool UseSplice)
+    : handle(Handle) {
+#ifdef __linux__
+    splicing = UseSplice;
+#else
+    splicing = false;
+#endif
+}
+
+inline size_t BSerializer::PipeSource::Transfer(int Destination, size_t Size) {
+    size_t t = 0;
+#ifdef __linux__
+    while (splicing && t < Size) {
+        ssize_t n = splice(handle, 0, Destination, 0, Size - t, SPLICE_F_MOVE | SPLICE_F_MORE);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EINVAL || errno == ENOSYS) {
+                splicing = false;
+                break;
+            }
+            throw std::system_error(errno, std::system_category(), "splice");
+        }
+        if (!n) return t;
+        t += (size_t)n;
+    }
+#endif
+    if (t < Size && !bounce) bounce.reset(new uint8_t[details::pageSize() * 16]);
+    while (t < Size) {
+        size_t s = Size - t;
+        if (s > details::pageSize() * 16) s = details::pageSize() * 16;
+        ssize_t n = read(handle, bounce.get(), s);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw std::system_error(errno, std::system_category(), "read");
+        }
+        if (!n) break;
+        details::writeAll(Destination, bounce.get(), (size_t)n);
+        t += (size_t)n;
+    }
+    return t;
+}
+
+__forceinline bool BSerializer::PipeSource::IsSplicing() const {
+    return splicing;
+}
+
+template <BSerializer::Serializable _T>
+inline BSerializer::PipeBenchmarkResult BSerializer::BenchmarkPipeSplice(const _T& Value, size_t Count) {
+    size_t bytes = SerializedSize(Value) * Count;
+    int sink = open("/dev/null", O_WRONLY);
+    if (sink < 0) throw std::system_error(errno, std::system_category(), "open");
+    PipeBenchmarkResult r = { bytes, 0, 0, true };
+    for (bool splicing : { false, true }) {
+        int p[2];
+        if (pipe(p)) {
+            int e = errno;
+            close(sink);
+            throw std::system_error(e, std::system_category(), "pipe");
+        }
+        bool readerSpliced = false;
+        auto t0 = std::chrono::steady_clock::now();
+        std::thread reader([&] {
+            PipeSource source(p[0], splicing);
+            source.Transfer(sink, bytes);
+            readerSpliced = source.IsSplicing();
+        });
+        PipeSink writer(p[1], splicing);
+        for (size_t i = 0; i < Count; ++i) writer.Send(Value);
+        close(p[1]);
+        reader.join();
+        auto t1 = std::chrono::steady_clock::now();
+        close(p[0]);
+        double rate = bytes / std::chrono::duration<double>(t1 - t0).count();
+        if (splicing) {
+            r.spliceBytesPerSecond = rate;
+            r.spliced = readerSpliced && writer.IsSplicing();
+        }
+        else r.copyBytesPerSecond = rate;
+    }
+    close(sink);
+    return r;
+}
+#endif
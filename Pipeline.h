@@ -0,0 +1,364 @@
+#pragma once
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "ChunkedSerializer.h"
+#include "Serializer.h"
+
+namespace BSerializer {
+    namespace details {
+        struct pipelineBuffer {
+            std::unique_ptr<uint8_t[]> data;
+            size_t size;
+        };
+    }
+
+    /**
+     * @brief Serializes records into a ring of buffers that a dedicated I/O thread writes out, so that serialization of one buffer overlaps the output of the others.
+     *
+     * The serializing thread and the I/O thread hand buffers to each other through a pair of atomic counters, without locks. When every buffer is waiting to be written, the serializing thread blocks until the I/O thread releases one.
+     * Records have the same format as those of BSerializer::AsyncFileWriter: the serialized size as a little-endian `uint64_t`, followed by the value.
+     * The output callback runs on the I/O thread. If it throws, the exception is rethrown on the serializing thread by the next call that hands off a buffer, and further output is discarded.
+     *
+     * Example:
+     * @code
+     * BSerializer::PipelinedWriter writer([file](const void* Data, size_t Size) { fwrite(Data, 1, Size, file); });
+     * for (const Record& r : snapshot) writer.Serialize(r);
+     * writer.Flush();
+     * @endcode
+     */
+    class PipelinedWriter final {
+    public:
+        /**
+         * @brief Starts the I/O thread.
+         * @param[in] Output The callback that writes a buffer. It is invoked on the I/O thread, one buffer at a time, in order.
+         * @param[in] BufferSize The size of each buffer, in bytes.
+         * @param[in] Depth The quantity of buffers. At least two are required for serialization to overlap output.
+         */
+        inline PipelinedWriter(std::function<void(const void* Data, size_t Size)> Output, size_t BufferSize = 1 << 20, size_t Depth = 2);
+        PipelinedWriter(const PipelinedWriter&) = delete;
+        PipelinedWriter& operator=(const PipelinedWriter&) = delete;
+        /**
+         * @brief Writes any buffered data and stops the I/O thread. Errors are not reported; call Flush first.
+         */
+        inline ~PipelinedWriter();
+
+        /**
+         * @brief Appends a value as a record.
+         * @tparam _T The type of the value serialized. _T must conform to BSerializer::Serializable.
+         * @param[in] Value The value to serialize. It is fully serialized before this function returns.
+         */
+        template <Serializable _T>
+        __forceinline void Serialize(const _T& Value);
+        /**
+         * @brief Appends raw data, without a record header.
+         * @param[in] Data A pointer to the data.
+         * @param[in] Size The size of the data, in bytes.
+         */
+        inline void Write(const void* Data, size_t Size);
+        /**
+         * @brief Hands off the partially filled buffer and waits until the I/O thread has written every buffer.
+         */
+        inline void Flush();
+    private:
+        std::function<void(const void*, size_t)> output;
+        std::vector<details::pipelineBuffer> buffers;
+        size_t bufferSize;
+        std::atomic<size_t> produced;
+        std::atomic<size_t> consumed;
+        std::atomic<bool> stopping;
+        std::atomic<bool> failed;
+        std::exception_ptr error;
+        std::thread io;
+
+        inline void Hand();
+        inline void Acquire(size_t Limit);
+        inline void Work();
+    };
+
+    /**
+     * @brief Deserializes records from a ring of buffers that a dedicated I/O thread fills ahead of the consumer, so that input overlaps deserialization.
+     *
+     * The I/O thread and the deserializing thread hand buffers to each other through a pair of atomic counters, without locks. When every buffer has been filled, the I/O thread blocks until the consumer releases one.
+     * Values are deserialized in place from the buffer that holds them; a record that spans buffers is first gathered into a contiguous spill buffer.
+     * The input callback runs on the I/O thread. If it throws, the exception is rethrown on the deserializing thread once the data read before the failure has been consumed.
+     */
+    class PipelinedReader final {
+    public:
+        /**
+         * @brief Starts the I/O thread, which begins reading immediately.
+         * @param[in] Input The callback that reads into a buffer. It returns the quantity of bytes read, and zero at the end of the input. It is invoked on the I/O thread.
+         * @param[in] BufferSize The size of each buffer, in bytes.
+         * @param[in] Depth The quantity of buffers. At least two are required for input to overlap deserialization.
+         */
+        inline PipelinedReader(std::function<size_t(void* Data, size_t Size)> Input, size_t BufferSize = 1 << 20, size_t Depth = 2);
+        PipelinedReader(const PipelinedReader&) = delete;
+        PipelinedReader& operator=(const PipelinedReader&) = delete;
+        /**
+         * @brief Stops the I/O thread once its current call to the input callback returns.
+         */
+        inline ~PipelinedReader();
+
+        /**
+         * @brief Deserializes the next record.
+         * @tparam _T The type of the value deserialized. _T must conform to BSerializer::Serializable.
+         * @param[out] Value A pointer to the location in memory in which the deserialized value will be placed.
+         * @return Whether a record was read. If not, the end of the input has been reached and nothing is written to Value.
+         */
+        template <Serializable _T>
+        __forceinline bool Deserialize(_T* Value);
+        /**
+         * @brief Reads raw data.
+         * @param[out] Data A pointer to the destination of the data.
+         * @param[in] Size The quantity of bytes to read.
+         * @return The quantity of bytes read. This is less than Size only if the end of the input has been reached.
+         */
+        inline size_t Read(void* Data, size_t Size);
+    private:
+        std::function<size_t(void*, size_t)> input;
+        std::vector<details::pipelineBuffer> buffers;
+        std::vector<uint8_t> spill;
+        size_t bufferSize;
+        std::atomic<size_t> filled;
+        std::atomic<size_t> released;
+        std::atomic<bool> stopping;
+        std::exception_ptr error;
+        size_t current;
+        size_t position;
+        bool holding;
+        std::thread io;
+
+        inline bool Advance();
+        inline const void* Contiguous(size_t Size);
+        inline bool Reserve(size_t Filled);
+        inline void Work();
+    };
+}
+
+inline BSerializer::PipelinedWriter::PipelinedWriter(std::function<void(const void* Data, size_t Size)> Output, size_t BufferSize, size_t Depth)
+    : output(std::move(Output)), buffers(Depth ? Depth : 1), bufferSize(BufferSize ? BufferSize : 1), produced(0), consumed(0), stopping(false), failed(false) {
+    for (details::pipelineBuffer& b : buffers) {
+        b.data.reset(new uint8_t[bufferSize]);
+        b.size = 0;
+    }
+    io = std::thread(&PipelinedWriter::Work, this);
+}
+
+inline BSerializer::PipelinedWriter::~PipelinedWriter() {
+    try {
+        Flush();
+    }
+    catch (...) { }
+    stopping.store(true, std::memory_order_relaxed);
+    produced.fetch_add(1, std::memory_order_release);
+    produced.notify_one();
+    io.join();
+}
+
+template <BSerializer::Serializable _T>
+__forceinline void BSerializer::PipelinedWriter::Serialize(const _T& Value) {
+    size_t size = SerializedSize(Value);
+    uint64_t header = ToFromLittleEndian((uint64_t)size);
+    Write(&header, sizeof(uint64_t));
+    details::pipelineBuffer& b = buffers[produced.load(std::memory_order_relaxed) % buffers.size()];
+    if (bufferSize - b.size >= size) {
+        void* p = b.data.get() + b.size;
+        BSerializer::Serialize(p, Value);
+        b.size += size;
+        return;
+    }
+    ChunkedSerializer serializer(Value);
+    while (true) {
+        details::pipelineBuffer& d = buffers[produced.load(std::memory_order_relaxed) % buffers.size()];
+        void* p = d.data.get() + d.size;
+        ChunkResult r = serializer.Serialize(p, bufferSize - d.size);
+        d.size = (uint8_t*)p - d.data.get();
+        if (r == ChunkResult::Complete) break;
+        Hand();
+    }
+}
+
+inline void BSerializer::PipelinedWriter::Write(const void* Data, size_t Size) {
+    const uint8_t* p = (const uint8_t*)Data;
+    while (Size) {
+        details::pipelineBuffer& b = buffers[produced.load(std::memory_order_relaxed) % buffers.size()];
+        size_t s = bufferSize - b.size;
+        if (s > Size) s = Size;
+        memcpy(b.data.get() + b.size, p, s);
+        b.size += s;
+        p += s;
+        Size -= s;
+        if (b.size == bufferSize) Hand();
+    }
+}
+
+inline void BSerializer::PipelinedWriter::Flush() {
+    if (buffers[produced.load(std::memory_order_relaxed) % buffers.size()].size) Hand();
+    Acquire(1);
+    if (failed.load(std::memory_order_acquire) && error) std::rethrow_exception(std::exchange(error, nullptr));
+}
+
+inline void BSerializer::PipelinedWriter::Hand() {
+    produced.fetch_add(1, std::memory_order_release);
+    produced.notify_one();
+    Acquire(buffers.size());
+    buffers[produced.load(std::memory_order_relaxed) % buffers.size()].size = 0;
+    if (failed.load(std::memory_order_acquire) && error) std::rethrow_exception(std::exchange(error, nullptr));
+}
+
+inline void BSerializer::PipelinedWriter::Acquire(size_t Limit) {
+    size_t p = produced.load(std::memory_order_relaxed);
+    size_t c = consumed.load(std::memory_order_acquire);
+    while (p - c >= Limit) {
+        consumed.wait(c, std::memory_order_acquire);
+        c = consumed.load(std::memory_order_acquire);
+    }
+}
+
+inline void BSerializer::PipelinedWriter::Work() {
+    size_t c = 0;
+    while (true) {
+        size_t p = produced.load(std::memory_order_acquire);
+        while (p == c) {
+            produced.wait(p, std::memory_order_acquire);
+            p = produced.load(std::memory_order_acquire);
+        }
+        if (stopping.load(std::memory_order_relaxed)) return;
+        details::pipelineBuffer& b = buffers[c % buffers.size()];
+        if (!failed.load(std::memory_order_relaxed)) {
+            try {
+                output(b.data.get(), b.size);
+            }
+            catch (...) {
+                error = std::current_exception();
+                failed.store(true, std::memory_order_release);
+            }
+        }
+        consumed.store(++c, std::memory_order_release);
+        consumed.notify_one();
+    }
+}
+
+inline BSerializer::PipelinedReader::PipelinedReader(std::function<size_t(void* Data, size_t Size)> Input, size_t BufferSize, size_t Depth)
+    : input(std::move(Input)), buffers(Depth ? Depth : 1), bufferSize(BufferSize ? BufferSize : 1), filled(0), released(0), stopping(false), current(0), position(0), holding(false) {
+    for (details::pipelineBuffer& b : buffers) {
+        b.data.reset(new uint8_t[bufferSize]);
+        b.size = 0;
+    }
+    io = std::thread(&PipelinedReader::Work, this);
+}
+
+inline BSerializer::PipelinedReader::~PipelinedReader() {
+    stopping.store(true, std::memory_order_release);
+    released.fetch_add(1, std::memory_order_release);
+    released.notify_one();
+    io.join();
+}
+
+template <BSerializer::Serializable _T>
+__forceinline bool BSerializer::PipelinedReader::Deserialize(_T* Value) {
+    uint64_t size;
+    if (Read(&size, sizeof(uint64_t)) < sizeof(uint64_t)) return false;
+    size = ToFromLittleEndian(size);
+    const void* p = Contiguous((size_t)size);
+    if (!p) throw std::out_of_range("The input ended in the middle of a record.");
+    BSerializer::Deserialize(p, Value);
+    return true;
+}
+
+inline size_t BSerializer::PipelinedReader::Read(void* Data, size_t Size) {
+    uint8_t* p = (uint8_t*)Data;
+    size_t t = 0;
+    while (t < Size) {
+        if (!holding || position == buffers[current % buffers.size()].size) {
+            if (!Advance()) break;
+            continue;
+        }
+        details::pipelineBuffer& b = buffers[current % buffers.size()];
+        size_t s = b.size - position;
+        if (s > Size - t) s = Size - t;
+        memcpy(p + t, b.data.get() + position, s);
+        position += s;
+        t += s;
+    }
+    return t;
+}
+
+inline bool BSerializer::PipelinedReader::Advance() {
+    if (holding) {
+        if (!buffers[current % buffers.size()].size) return false;
+        released.store(++current, std::memory_order_release);
+        released.notify_one();
+        holding = false;
+    }
+    size_t f = filled.load(std::memory_order_acquire);
+    while (f == current) {
+        filled.wait(f, std::memory_order_acquire);
+        f = filled.load(std::memory_order_acquire);
+    }
+    holding = true;
+    position = 0;
+    if (!buffers[current % buffers.size()].size) {
+        if (error) std::rethrow_exception(std::exchange(error, nullptr));
+        return false;
+    }
+    return true;
+}
+
+inline const void* BSerializer::PipelinedReader::Contiguous(size_t Size) {
+    if (holding) {
+        details::pipelineBuffer& b = buffers[current % buffers.size()];
+        if (b.size - position >= Size) {
+            const void* p = b.data.get() + position;
+            position += Size;
+            return p;
+        }
+    }
+    spill.resize(Size);
+    if (Read(spill.data(), Size) < Size) return 0;
+    return spill.data();
+}
+
+inline bool BSerializer::PipelinedReader::Reserve(size_t Filled) {
+    size_t r = released.load(std::memory_order_acquire);
+    while (true) {
+        if (stopping.load(std::memory_order_acquire)) return false;
+        if (Filled - r < buffers.size()) return true;
+        released.wait(r, std::memory_order_acquire);
+        r = released.load(std::memory_order_acquire);
+    }
+}
+
+inline void BSerializer::PipelinedReader::Work() {
+    size_t f = 0;
+    while (true) {
+        if (!Reserve(f)) return;
+        details::pipelineBuffer& b = buffers[f % buffers.size()];
+        b.size = 0;
+        try {
+            while (b.size < bufferSize) {
+                size_t n = input(b.data.get() + b.size, bufferSize - b.size);
+                if (!n) break;
+                b.size += n;
+            }
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+        bool end = b.size < bufferSize;
+        if (end && b.size) {
+            filled.store(++f, std::memory_order_release);
+            filled.notify_one();
+            if (!Reserve(f)) return;
+            buffers[f % buffers.size()].size = 0;
+        }
+        filled.store(++f, std::memory_order_release);
+        filled.notify_one();
+        if (end) return;
+    }
+}
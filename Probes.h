@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include "TypeName.h"
+
+/**
+ * Static tracepoints for perf, bpftrace and SystemTap, under the provider name "bserializer".
+ *
+ * The probes are compiled in when BSERIALIZER_PROBES is defined before BSerializer is included and <sys/sdt.h> is available; otherwise every probe compiles to nothing.
+ * An unattached probe costs a single no-op instruction. Type hashes are those returned by BSerializer::TypeHash, and names those returned by BSerializer::TypeName.
+ *
+ * - serialize__start(hash, name), serialize__end(hash, bytes): an outermost call to BSerializer::Serialize on a non-scalar type.
+ * - deserialize__start(hash, name), deserialize__end(hash, bytes): an outermost call to BSerializer::Deserialize on a non-scalar type.
+ * - collection__decode__start(hash, length), collection__decode__end(hash, length): the decoding of any collection, including nested ones.
+ * - alloc(hash, bytes): the scratch allocation for the elements of a collection being decoded. The hash is that of the element type.
+ *
+ * Example:
+ * @code
+ * bpftrace -e 'usdt:./app:bserializer:deserialize__start { @s[tid] = nsecs; } usdt:./app:bserializer:deserialize__end /@s[tid]/ { @ns[arg0] = hist(nsecs - @s[tid]); delete(@s[tid]); }'
+ * @endcode
+ */
+#if defined(BSERIALIZER_PROBES) && __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define BSERIALIZER_PROBE(Name, A, B) STAP_PROBE2(bserializer, Name, A, B)
+#define BSERIALIZER_PROBE_SCOPE(Type, Deserializing, Data) BSerializer::details::probeScope<Type, Deserializing> bserializerProbeScope(Data)
+#else
+#define BSERIALIZER_PROBE(Name, A, B) ((void)0)
+#define BSERIALIZER_PROBE_SCOPE(Type, Deserializing, Data) ((void)0)
+#endif
+
+namespace BSerializer {
+    namespace details {
+        inline thread_local size_t probeDepth = 0;
+
+        template <typename _T, bool _Deserializing>
+        class probeScope final {
+        public:
+            template <typename _TPtr>
+            __forceinline explicit probeScope(_TPtr* const& Data);
+            __forceinline ~probeScope();
+            probeScope(const probeScope&) = delete;
+            probeScope& operator=(const probeScope&) = delete;
+        private:
+            const void* const* data;
+            const void* begin;
+            bool outer;
+        };
+    }
+}
+
+template <typename _T, bool _Deserializing>
+template <typename _TPtr>
+__forceinline BSerializer::details::probeScope<_T, _Deserializing>::probeScope(_TPtr* const& Data)
+    : data((const void* const*)&Data), begin(Data), outer(false) {
+    if constexpr (!std::is_scalar_v<_T>) {
+        outer = !probeDepth++;
+        if (outer) {
+            if constexpr (_Deserializing) BSERIALIZER_PROBE(deserialize__start, TypeHash<_T>(), TypeName<_T>());
+            else BSERIALIZER_PROBE(serialize__start, TypeHash<_T>(), TypeName<_T>());
+        }
+    }
+}
+
+template <typename _T, bool _Deserializing>
+__forceinline BSerializer::details::probeScope<_T, _Deserializing>::~probeScope() {
+    if constexpr (!std::is_scalar_v<_T>) {
+        --probeDepth;
+        if (outer) {
+            size_t bytes = (const uint8_t*)*data - (const uint8_t*)begin;
+            if constexpr (_Deserializing) BSERIALIZER_PROBE(deserialize__end, TypeHash<_T>(), bytes);
+            else BSERIALIZER_PROBE(serialize__end, TypeHash<_T>(), bytes);
+        }
+    }
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <latch>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "AllocationTracker.h"
+#include "Serializer.h"
+
+#if __has_include(<linux/perf_event.h>)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define BSERIALIZER_PERF_EVENTS
+#endif
+
+namespace BSerializer {
+    /**
+     * @brief The measurements of one thread count in BSerializer::BenchmarkScaling.
+     */
+    struct ScalingBenchmarkResult final {
+        /**
+         * @brief The quantity of threads running concurrently.
+         */
+        size_t threads;
+        /**
+         * @brief The mean serialization throughput of each thread, in values per second.
+         */
+        double serializePerThread;
+        /**
+         * @brief The mean deserialization throughput of each thread, in values per second, including the destruction of the values.
+         */
+        double deserializePerThread;
+        /**
+         * @brief The mean quantity of heap allocations per deserialized value. Allocations through operator new are included only if the counting hooks of BSerializer::AllocationScope are installed.
+         */
+        double allocationsPerValue;
+        /**
+         * @brief The total quantity of hardware cache misses of the threads while deserializing, or -1 if `perf_event_open` is unavailable or not permitted.
+         */
+        int64_t cacheMisses;
+    };
+
+    /**
+     * @brief Runs independent serialization and deserialization workloads on increasing quantities of threads, so that contention shows as a fall in per-thread throughput.
+     *
+     * Each thread serializes every value into a buffer of its own, then deserializes them back, Iterations times. The threads start serializing together, and start deserializing together only once every thread has finished serializing, so the two phases never overlap. Thread counts run from 1 up to MaxThreads, doubling each time.
+     * @tparam _T The type of the values. _T must conform to BSerializer::Serializable.
+     * @param[in] Values The workload of each thread.
+     * @param[in] MaxThreads The largest quantity of threads to run.
+     * @param[in] Iterations The quantity of passes over the values per thread.
+     * @return One result per thread count.
+     */
+    template <Serializable _T>
+    inline std::vector<ScalingBenchmarkResult> BenchmarkScaling(const std::vector<_T>& Values, size_t MaxThreads = std::thread::hardware_concurrency(), size_t Iterations = 10);
+
+    namespace details {
+        class cacheMissCounter final {
+        public:
+            inline cacheMissCounter();
+            inline ~cacheMissCounter();
+            cacheMissCounter(const cacheMissCounter&) = delete;
+            cacheMissCounter& operator=(const cacheMissCounter&) = delete;
+
+            inline void Start();
+            inline int64_t Stop();
+        private:
+            int handle;
+        };
+
+        struct scalingSample {
+            std::chrono::nanoseconds serialize;
+            std::chrono::nanoseconds deserialize;
+            size_t allocations;
+            int64_t cacheMisses;
+        };
+    }
+}
+
+inline BSerializer::details::cacheMissCounter::cacheMissCounter()
+    : handle(-1) {
+#ifdef BSERIALIZER_PERF_EVENTS
+    perf_event_attr a = { };
+    a.type = PERF_TYPE_HARDWARE;
+    a.size = sizeof(a);
+    a.config = PERF_COUNT_HW_CACHE_MISSES;
+    a.disabled = 1;
+    a.exclude_kernel = 1;
+    a.exclude_hv = 1;
+    handle = (int)syscall(SYS_perf_event_open, &a, 0, -1, -1, 0);
+#endif
+}
+
+inline BSerializer::details::cacheMissCounter::~cacheMissCounter() {
+#ifdef BSERIALIZER_PERF_EVENTS
+    if (handle >= 0) close(handle);
+#endif
+}
+
+inline void BSerializer::details::cacheMissCounter::Start() {
+#ifdef BSERIALIZER_PERF_EVENTS
+    if (handle < 0) return;
+    ioctl(handle, PERF_EVENT_IOC_RESET, 0);
+    ioctl(handle, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+}
+
+inline int64_t BSerializer::details::cacheMissCounter::Stop() {
+#ifdef BSERIALIZER_PERF_EVENTS
+    if (handle < 0) return -1;
+    ioctl(handle, PERF_EVENT_IOC_DISABLE, 0);
+    uint64_t c;
+    if (read(handle, &c, sizeof(c)) != sizeof(c)) return -1;
+    return (int64_t)c;
+#else
+    return -1;
+#endif
+}
+
+template <BSerializer::Serializable _T>
+inline std::vector<BSerializer::ScalingBenchmarkResult> BSerializer::BenchmarkScaling(const std::vector<_T>& Values, size_t MaxThreads, size_t Iterations) {
+    size_t bytes = 0;
+    for (const _T& v : Values) bytes += SerializedSize(v);
+    if (!MaxThreads) MaxThreads = 1;
+    if (!Iterations) Iterations = 1;
+    std::vector<ScalingBenchmarkResult> results;
+    for (size_t n = 1;; n = n * 2 < MaxThreads ? n * 2 : MaxThreads) {
+        std::vector<details::scalingSample> samples(n);
+        std::latch ready((ptrdiff_t)n);
+        std::latch serialized((ptrdiff_t)n);
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < n; ++t) threads.emplace_back([&, t] {
+            details::scalingSample& s = samples[t];
+            std::unique_ptr<uint8_t[]> buffer(new uint8_t[bytes ? bytes : 1]);
+            std::unique_ptr<uint8_t[]> scratch(new uint8_t[sizeof(_T) + alignof(_T)]);
+            _T* value = (_T*)(((uintptr_t)scratch.get() + alignof(_T) - 1) & ~(uintptr_t)(alignof(_T) - 1));
+            details::cacheMissCounter counter;
+            ready.arrive_and_wait();
+            auto t0 = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < Iterations; ++i) {
+                void* p = buffer.get();
+                for (const _T& v : Values) Serialize(p, v);
+            }
+            auto t1 = std::chrono::steady_clock::now();
+            serialized.arrive_and_wait();
+            AllocationScope scope;
+            counter.Start();
+            auto t2 = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < Iterations; ++i) {
+                const void* p = buffer.get();
+                for (size_t j = 0; j < Values.size(); ++j) {
+                    Deserialize<_T>(p, value);
+                    value->~_T();
+                }
+            }
+            auto t3 = std::chrono::steady_clock::now();
+            s.cacheMisses = counter.Stop();
+            s.allocations = scope.Counts().allocations;
+            s.serialize = t1 - t0;
+            s.deserialize = t3 - t2;
+        });
+        for (std::thread& t : threads) t.join();
+        ScalingBenchmarkResult r = { n, 0, 0, 0, 0 };
+        double count = (double)(Values.size() * Iterations);
+        size_t allocations = 0;
+        for (const details::scalingSample& s : samples) {
+            r.serializePerThread += count / std::chrono::duration<double>(s.serialize).count() / n;
+            r.deserializePerThread += count / std::chrono::duration<double>(s.deserialize).count() / n;
+            allocations += s.allocations;
+            if (s.cacheMisses < 0 || r.cacheMisses < 0) r.cacheMisses = -1;
+            else r.cacheMisses += s.cacheMisses;
+        }
+        r.allocationsPerValue = count ? allocations / (count * n) : 0;
+        results.push_back(r);
+        if (n == MaxThreads) break;
+    }
+    return results;
+}
@@ -6,6 +6,8 @@
 #include <optional>
 #include <variant>
 #include <chrono>
+#include <ranges>
+#include "Platform.h"
 
 namespace BSerializer {
     /**
@@ -105,8 +107,8 @@ namespace BSerializer {
             { CIt1 != CIt2 } -> std::same_as<bool>;
         };
 
-        requires requires(const std::initializer_list<typename _T::value_type> InitList) {
-            _T(InitList);
+        requires requires(const typename _T::value_type* Lower, const typename _T::value_type* Upper) {
+            _T(Lower, Upper);
         };
     };
 
@@ -182,12 +184,9 @@ namespace BSerializer {
         template <typename _T>
         struct isSerializableStdTuple
             : std::false_type { };
-        template <>
-        struct isSerializableStdTuple<std::tuple<>>
-            : std::true_type { };
-        template <typename _TFirst, typename... _Ts>
-        struct isSerializableStdTuple<std::tuple<_TFirst, _Ts...>>
-            : std::bool_constant<isSerializable<_TFirst>::value && isSerializableStdTuple<std::tuple<_Ts...>>::value> { };
+        template <typename... _Ts>
+        struct isSerializableStdTuple<std::tuple<_Ts...>>
+            : std::bool_constant<(isSerializable<_Ts>::value && ...)> { };
 
         template <typename _T>
         struct isSerializableCollection
@@ -268,21 +267,25 @@ namespace BSerializer {
         struct isStdTimePoint<std::chrono::time_point<_Clock, _Duration>>
             : std::true_type { };
         
+        template <typename _T>
+        struct isBuiltInSerializable
+            : std::bool_constant<BuiltInSerializable<_T>> { };
+
         template <typename _T>
         struct isSerializable
-            : std::bool_constant<
-                std::is_arithmetic_v<_T> ||
-                isSerializableStdPair<_T>::value ||
-                isSerializableStdTuple<_T>::value ||
-                isSerializableCollection<_T>::value ||
-                isSerializableMap<_T>::value ||
-                isStdComplex<_T>::value ||
-                isSerializableStdArray<_T>::value ||
-                isSerializableStdOptional<_T>::value ||
-                isSerializableStdVariant<_T>::value ||
-                isStdDuration<_T>::value ||
-                isStdTimePoint<_T>::value ||
-                BuiltInSerializable<_T>
+            : std::disjunction<
+                std::is_arithmetic<_T>,
+                isSerializableStdPair<_T>,
+                isSerializableStdTuple<_T>,
+                isSerializableCollection<_T>,
+                isSerializableMap<_T>,
+                isStdComplex<_T>,
+                isSerializableStdArray<_T>,
+                isSerializableStdOptional<_T>,
+                isSerializableStdVariant<_T>,
+                isStdDuration<_T>,
+                isStdTimePoint<_T>,
+                isBuiltInSerializable<_T>
             > { };
     }
 
@@ -435,4 +438,14 @@ namespace BSerializer {
      */
     template <typename _T>
     concept Serializable = details::isSerializable<_T>::value;
+
+    /**
+     * @brief Concept to check if a type is an input range whose elements are (de)serializable by BSerializer.
+     *
+     * Unlike BSerializer::SerializableCollection, a SerializableRange need not be constructible, so views and other lazy ranges conform. Serialized ranges share the wire format of collections.
+     *
+     * @tparam _T The type whose conformity is evaluated.
+     */
+    template <typename _T>
+    concept SerializableRange = std::ranges::input_range<_T> && Serializable<std::ranges::range_value_t<_T>>;
 }
\ No newline at end of file
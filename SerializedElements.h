@@ -0,0 +1,185 @@
+#pragma once
+
+#include <optional>
+#include <ranges>
+#include "Serializer.h"
+
+namespace BSerializer {
+    /**
+     * @brief A view that lazily deserializes the elements of a serialized collection as it is iterated.
+     *
+     * An element is decoded only when its iterator is dereferenced, and each element is decoded at most once per pass, so composing the view with `std::views::take` or `std::views::filter` stops decoding as soon as iteration stops.
+     * Elements that are skipped without being dereferenced are still decoded to advance past them. The serialized data must outlive the view.
+     *
+     * Example:
+     * @code
+     * for (const Record& r : BSerializer::Elements<std::vector<Record>>(data) | std::views::filter(IsMatch) | std::views::take(3)) {
+     *     Process(r);
+     * }
+     * @endcode
+     *
+     * @tparam _T The type of the elements. _T must conform to BSerializer::Serializable.
+     * @tparam _E The byte order of the serialized data.
+     */
+    template <Serializable _T, std::endian _E = std::endian::little>
+    class SerializedElements final
+        : public std::ranges::view_interface<SerializedElements<_T, _E>> {
+    public:
+        class Iterator final {
+            friend class SerializedElements<_T, _E>;
+        public:
+            using value_type = _T;
+            using difference_type = ptrdiff_t;
+
+            Iterator() = default;
+            Iterator(Iterator&&) = default;
+            Iterator& operator=(Iterator&&) = default;
+
+            /**
+             * @brief Returns the current element, deserializing it if it has not been already.
+             * @return A reference to the current element, valid until the iterator is incremented.
+             */
+            __forceinline const _T& operator*() const;
+            /**
+             * @brief Advances to the next element.
+             * @return A reference to this iterator.
+             */
+            __forceinline Iterator& operator++();
+            /**
+             * @brief Advances to the next element.
+             */
+            __forceinline void operator++(int);
+            /**
+             * @brief Returns a pointer to the serialized data that follows the elements read so far. Once every element has been passed, this is the end of the serialized collection.
+             * @return A pointer to the serialized data that follows the elements read so far.
+             */
+            __forceinline const void* Data() const;
+
+            __forceinline friend bool operator==(const Iterator& Iterator, std::default_sentinel_t) {
+                return !Iterator.remaining;
+            }
+        private:
+            mutable const void* data = 0;
+            size_t remaining = 0;
+            mutable std::optional<_T> current;
+            uint64_t bits = 0;
+            size_t index = 0;
+
+            __forceinline Iterator(const void* Data, size_t Length);
+            __forceinline void Decode() const;
+        };
+
+        SerializedElements() = default;
+        /**
+         * @brief Creates a view over a serialized collection. Only the length prefix is read.
+         * @param[in] Data A pointer to the serialized collection.
+         */
+        __forceinline explicit SerializedElements(const void* Data);
+
+        /**
+         * @brief Returns an iterator to the first element. Each call starts a new pass over the serialized data, so the view may be iterated more than once; every pass decodes the elements again.
+         * @return An iterator to the first element.
+         */
+        __forceinline Iterator begin() const;
+        /**
+         * @brief Returns the sentinel marking the end of the elements.
+         * @return The sentinel marking the end of the elements.
+         */
+        __forceinline std::default_sentinel_t end() const;
+        /**
+         * @brief Returns the quantity of elements in the serialized collection.
+         * @return The quantity of elements in the serialized collection.
+         */
+        __forceinline size_t size() const;
+    private:
+        const void* data = 0;
+        size_t length = 0;
+    };
+
+    /**
+     * @brief Returns an input view that lazily deserializes the elements of a serialized collection.
+     * @tparam _T The type of the serialized collection. _T must conform to BSerializer::SerializableCollection.
+     * @tparam _E The byte order of the serialized data.
+     * @param[in] Data A pointer to the serialized collection.
+     * @return A view over the elements of the serialized collection.
+     */
+    template <SerializableCollection _T, std::endian _E = std::endian::little>
+    __forceinline SerializedElements<typename _T::value_type, _E> Elements(const void* Data);
+}
+
+template <BSerializer::Serializable _T, std::endian _E>
+__forceinline BSerializer::SerializedElements<_T, _E>::Iterator::Iterator(const void* Data, size_t Length)
+    : data(Data), remaining(Length) {
+    if constexpr (std::same_as<_T, bool>) {
+        if (remaining) bits = details::deserializeBoolChunk(data, remaining);
+    }
+}
+
+template <BSerializer::Serializable _T, std::endian _E>
+__forceinline void BSerializer::SerializedElements<_T, _E>::Iterator::Decode() const {
+    alignas(_T) uint8_t bytes[sizeof(_T)];
+    _T* p_v = (_T*)bytes;
+    BSerializer::Deserialize<_E>(data, p_v);
+    current.emplace(std::move(*p_v));
+    p_v->~_T();
+}
+
+template <BSerializer::Serializable _T, std::endian _E>
+__forceinline const _T& BSerializer::SerializedElements<_T, _E>::Iterator::operator*() const {
+    if constexpr (std::same_as<_T, bool>) {
+        current = (bool)((bits >> (index & 63)) & 1);
+    }
+    else if (!current) Decode();
+    return *current;
+}
+
+template <BSerializer::Serializable _T, std::endian _E>
+__forceinline typename BSerializer::SerializedElements<_T, _E>::Iterator& BSerializer::SerializedElements<_T, _E>::Iterator::operator++() {
+    if constexpr (std::same_as<_T, bool>) {
+        ++index;
+        --remaining;
+        if (remaining && !(index & 63)) bits = details::deserializeBoolChunk(data, remaining);
+    }
+    else {
+        if (!current) Decode();
+        current.reset();
+        --remaining;
+    }
+    return *this;
+}
+
+template <BSerializer::Serializable _T, std::endian _E>
+__forceinline void BSerializer::SerializedElements<_T, _E>::Iterator::operator++(int) {
+    ++*this;
+}
+
+template <BSerializer::Serializable _T, std::endian _E>
+__forceinline const void* BSerializer::SerializedElements<_T, _E>::Iterator::Data() const {
+    return data;
+}
+
+template <BSerializer::Serializable _T, std::endian _E>
+__forceinline BSerializer::SerializedElements<_T, _E>::SerializedElements(const void* Data)
+    : data(Data) {
+    length = BSerializer::Deserialize<_E, size_t>(data);
+}
+
+template <BSerializer::Serializable _T, std::endian _E>
+__forceinline typename BSerializer::SerializedElements<_T, _E>::Iterator BSerializer::SerializedElements<_T, _E>::begin() const {
+    return Iterator(data, length);
+}
+
+template <BSerializer::Serializable _T, std::endian _E>
+__forceinline std::default_sentinel_t BSerializer::SerializedElements<_T, _E>::end() const {
+    return std::default_sentinel;
+}
+
+template <BSerializer::Serializable _T, std::endian _E>
+__forceinline size_t BSerializer::SerializedElements<_T, _E>::size() const {
+    return length;
+}
+
+template <BSerializer::SerializableCollection _T, std::endian _E>
+__forceinline BSerializer::SerializedElements<typename _T::value_type, _E> BSerializer::Elements(const void* Data) {
+    return SerializedElements<typename _T::value_type, _E>(Data);
+}
@@ -1,12 +1,73 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <bit>
+#include <cstring>
 #include <iterator>
+#include <memory>
 #include <utility>
 #include <tuple>
 #include <exception>
+#include "BufferPool.h"
+#include "DeserializationContext.h"
+#include "Instrumentation.h"
+#include "Probes.h"
 #include "Serializable.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h>
+#define BSERIALIZER_STREAMING_STORES
+#endif
+
+/**
+ * Out-of-line mode, for binaries where the size of the serialization code matters more than the overhead of calls.
+ *
+ * By default, BSerializer force-inlines the serialization of every type into its caller. When BSERIALIZER_OUT_OF_LINE is defined before BSerializer is included, only scalar types (arithmetic types, std::complex, std::chrono::duration and std::chrono::time_point) are force-inlined,
+ * and the serialization of each composite type is compiled as a function of its own and called. This trades a call per composite value, which is most visible on collections of short strings, for far less code in each caller.
+ *
+ * BSERIALIZER_INSTANTIATE(Type) explicitly instantiates the little-endian BSerializer::SerializedSize, BSerializer::Serialize and BSerializer::Deserialize of a composite type in the translation unit that expands it.
+ * BSERIALIZER_EXTERN(Type), expanded in every other translation unit, makes them refer to that instantiation instead of compiling their own. Both are expanded at global scope, after BSerializer is included.
+ *
+ * Example:
+ * @code
+ * // Messages.h
+ * #define BSERIALIZER_OUT_OF_LINE
+ * #include "Serializer.h"
+ * BSERIALIZER_EXTERN(std::vector<Order>)
+ *
+ * // Messages.cpp
+ * #include "Messages.h"
+ * BSERIALIZER_INSTANTIATE(std::vector<Order>)
+ * @endcode
+ */
+#ifdef BSERIALIZER_OUT_OF_LINE
+#if defined(_MSC_VER)
+#define BSERIALIZER_COMPOSITE __declspec(noinline)
+#else
+#define BSERIALIZER_COMPOSITE __attribute__((noinline))
+#endif
+#else
+#define BSERIALIZER_COMPOSITE __forceinline
+#endif
+
+#if defined(_MSC_VER)
+#define BSERIALIZER_COLD __declspec(noinline)
+#else
+#define BSERIALIZER_COLD __attribute__((cold))
+#endif
+
+#define BSERIALIZER_INSTANTIATE(...) \
+    static_assert(!BSerializer::details::isScalarSerializable<__VA_ARGS__>, "Only composite types are instantiated out of line."); \
+    template size_t BSerializer::details::serializedSizeComposite<__VA_ARGS__>(const __VA_ARGS__&); \
+    template void BSerializer::details::serializeComposite<std::endian::little, __VA_ARGS__>(void*&, const __VA_ARGS__&); \
+    template void BSerializer::details::deserializeComposite<std::endian::little, __VA_ARGS__>(const void*&, void*);
+#define BSERIALIZER_EXTERN(...) \
+    static_assert(!BSerializer::details::isScalarSerializable<__VA_ARGS__>, "Only composite types are instantiated out of line."); \
+    extern template size_t BSerializer::details::serializedSizeComposite<__VA_ARGS__>(const __VA_ARGS__&); \
+    extern template void BSerializer::details::serializeComposite<std::endian::little, __VA_ARGS__>(void*&, const __VA_ARGS__&); \
+    extern template void BSerializer::details::deserializeComposite<std::endian::little, __VA_ARGS__>(const void*&, void*);
+
 namespace BSerializer {
     namespace details {
         template <typename _T>
@@ -15,47 +76,124 @@ namespace BSerializer {
         template <typename _T>
         __forceinline void byteSwap(_T& Bytes);
 
-        template <typename _TTuple, size_t _Index, typename _TFirst, typename... _TsAll>
-        struct tupleDeserializer2 {
-            __forceinline static void DeserializeTuple(const void*& Data, _TTuple& Tuple);
-        };
+        /**
+         * @brief Scratch storage for values being deserialized, taken from the calling thread's pool. The values constructed so far, from lower up to upper, are destroyed and the storage is released when it goes out of scope, including on unwind.
+         */
+        template <typename _T>
+        struct decodeScratch final {
+            PooledBuffer buffer;
+            _T* lower;
+            _T* upper;
 
-        template <typename _TTuple>
-        struct tupleDeserializer;
+            __forceinline explicit decodeScratch(size_t Count);
+            decodeScratch(const decodeScratch&) = delete;
+            decodeScratch& operator=(const decodeScratch&) = delete;
+            __forceinline ~decodeScratch();
+        };
 
-        template <typename _TFirst, typename... _TsAll>
-        struct tupleDeserializer<std::tuple<_TFirst, _TsAll...>> final
-            : tupleDeserializer2<std::tuple<_TFirst, _TsAll...>, 0, _TFirst, _TsAll...> { };
+        template <typename _T>
+        constexpr bool isScalarSerializable = Arithmetic<_T> || StdComplex<_T> || StdDuration<_T> || StdTimePoint<_T>;
 
-        template <typename _TTuple>
-        __forceinline static void DeserializeTuple(const void*& Data, _TTuple& Tuple);
+        template <typename _T>
+        BSERIALIZER_COMPOSITE size_t serializedSizeComposite(const _T& Value);
 
-        template <size_t _Index, typename... _Ts>
-        struct variantHelper2 {
-            static size_t SerializedSize(const std::variant<_Ts...>& Variant);
+        template <std::endian _E, typename _T>
+        BSERIALIZER_COMPOSITE void serializeComposite(void*& Data, const _T& Value);
 
-            static void Serialize(void*& Data, const std::variant<_Ts...>& Variant);
+        template <std::endian _E, typename _T>
+        BSERIALIZER_COMPOSITE void deserializeComposite(const void*& Data, void* Value);
 
-            static void Deserialize(const void*& Data, size_t Index, std::variant<_Ts...>* Variant);
-        };
+        [[noreturn]] BSERIALIZER_COLD inline void throwOutOfRange(const char* Message);
 
-        template <typename _T>
-        struct variantHelper;
+        template <std::endian _E, typename _TTuple>
+        __forceinline static void DeserializeTuple(const void*& Data, _TTuple& Tuple);
 
+        template <typename _TVariant>
+        constexpr bool variantHasMonostate = false;
         template <typename... _Ts>
-        struct variantHelper<std::variant<_Ts...>>
-            : variantHelper2<0, _Ts...> { };
+        constexpr bool variantHasMonostate<std::variant<_Ts...>> = (std::same_as<std::monostate, _Ts> || ...);
+
+        template <size_t _Index, typename _TVariant>
+        size_t variantAlternativeSize(const _TVariant& Variant);
+
+        template <std::endian _E, size_t _Index, typename _TVariant>
+        void variantAlternativeSerialize(void*& Data, const _TVariant& Variant);
+
+        template <std::endian _E, size_t _Index, typename _TVariant>
+        void variantAlternativeDeserialize(const void*& Data, _TVariant* Variant);
 
         template <typename _TVariant>
         size_t variantSerializedSize(const _TVariant& Variant);
 
-        template <typename _TVariant>
+        template <std::endian _E, typename _TVariant>
         void variantSerialize(void*& Data, const _TVariant& Variant);
 
-        template <typename _TVariant>
+        template <std::endian _E, typename _TVariant>
         void variantDeserialize(const void*& Data, _TVariant* Variant);
+
+        template <typename _T, typename _TFunc>
+        struct isMapEntryCallback
+            : std::false_type { };
+        template <Map _T, typename _TFunc>
+        struct isMapEntryCallback<_T, _TFunc>
+            : std::bool_constant<std::invocable<_TFunc&, typename _T::key_type&&, typename _T::mapped_type&&>> { };
+
+        __forceinline uint64_t deserializeBoolChunk(const void*& Data, size_t Remaining);
+
+        template <std::endian _E, typename _T, typename _TFunc>
+        __forceinline void forEachSerializedElement(const void*& Data, size_t Length, _TFunc& Callback);
+
+        template <bool _Bounded, typename _TRange>
+        __forceinline size_t serializeBoolRange(void*& Data, const void* End, _TRange&& Range);
+
+        template <std::endian _E, bool _Bounded, typename _TRange>
+        __forceinline void serializeRange(void*& Data, const void* End, _TRange&& Range);
+
+        inline std::atomic<size_t> streamingThreshold = 16 << 20;
+
+        template <bool _PrefetchSource>
+        inline void streamingCopy(void* Destination, const void* Source, size_t Size);
+
+        template <bool _PrefetchSource>
+        __forceinline void bulkCopy(void* Destination, const void* Source, size_t Size);
+
+        constexpr size_t prefetchDistance = 8;
+
+        template <typename _T>
+        struct hasPayload
+            : std::false_type { };
+        template <Collection _T>
+            requires std::contiguous_iterator<typename _T::const_iterator>
+        struct hasPayload<_T>
+            : std::true_type { };
+        template <typename _T1, typename _T2>
+        struct hasPayload<std::pair<_T1, _T2>>
+            : std::bool_constant<hasPayload<std::remove_cv_t<_T1>>::value || hasPayload<std::remove_cv_t<_T2>>::value> { };
+
+        template <typename _T>
+        concept prefetchedCollection = std::contiguous_iterator<typename _T::const_iterator> && hasPayload<typename _T::value_type>::value;
+
+        __forceinline void prefetch(const void* Address);
+
+        template <typename _T>
+        __forceinline void prefetchPayload(const _T& Value);
+
+        template <typename _T, typename _TFunc>
+        __forceinline void forEachPrefetched(const _T& Value, _TFunc&& Func);
     }
 
+    /**
+     * @brief An empty tag that selects the byte order of serialized data where a template argument cannot be given explicitly, such as in constructors.
+     * @tparam _E The byte order of the serialized data.
+     */
+    template <std::endian _E>
+    struct EndianTag { };
+
+    /**
+     * @brief The size of the header written by BSerializer::SerializeWireHeader, in bytes.
+     */
+    constexpr size_t WireHeaderSize = 8;
+
     /**
      * @brief If the architecture is big-endian, the function will reverse the order of the bytes of Value. If not, the function returns the value it was given.
      * @tparam _T The type of the value.
@@ -80,6 +218,31 @@ namespace BSerializer {
      */
     template <typename _T>
     __forceinline void ToFromLittleEndian(_T* Array, size_t Length);
+    /**
+     * @brief If the byte order _E differs from that of the architecture, the function will reverse the order of the bytes of Value. If not, the function returns the value it was given.
+     * @tparam _E The byte order converted to or from.
+     * @tparam _T The type of the value.
+     * @param[in] Value The value whose bytes are conditionally reversed.
+     * @return The resulting value.
+     */
+    template <std::endian _E, typename _T>
+    __forceinline _T ToFromEndian(_T Value);
+
+    /**
+     * @brief Writes a header identifying the byte order and the width of `size_t` used by the data that follows, so that a peer can verify that it decodes the data the same way.
+     * @tparam _E The byte order of the data that follows. If _E is std::endian::native, the architecture's byte order is recorded.
+     * @param[out] Data A pointer to the destination of the header. After serialization, the pointer will be adjusted by BSerializer::WireHeaderSize.
+     */
+    template <std::endian _E>
+    __forceinline void SerializeWireHeader(void*& Data);
+    /**
+     * @brief Checks a header written by BSerializer::SerializeWireHeader against the byte order _E and the width of `size_t` on this architecture.
+     * @tparam _E The byte order with which the data that follows will be deserialized.
+     * @param[in,out] Data A pointer to the header. If the header matches, the pointer will be adjusted by BSerializer::WireHeaderSize; otherwise, it is left unchanged.
+     * @return Whether the header matches.
+     */
+    template <std::endian _E>
+    __forceinline bool CheckWireHeader(const void*& Data);
 
     /**
      * @brief Returns what the serialized size of a value in memory would be if it were serialized.
@@ -146,6 +309,70 @@ namespace BSerializer {
     template <Serializable _T>
     __forceinline void Deserialize(void*& Data, void* Value);
 
+    /**
+     * @brief Serializes a value with the given byte order.
+     * @tparam _E The byte order of the serialized data. std::endian::native performs no conversion, and is appropriate only when both ends share an architecture.
+     * @tparam _T The type of the value serialized. _T must conform to BSerializer::Serializable.
+     * @param[out] Data A pointer to the destination of the serialized data. After serialization, the pointer will be adjusted by the size of the data written.
+     * @param[in] Value The value to serialize.
+     */
+    template <std::endian _E, Serializable _T>
+    __forceinline void Serialize(void*& Data, const _T& Value);
+    /**
+     * @brief Deserializes a value with the given byte order.
+     * @tparam _E The byte order of the serialized data. std::endian::native performs no conversion, and is appropriate only when both ends share an architecture.
+     * @tparam _T The type of the value deserialized. _T must conform to BSerializer::Serializable.
+     * @param[in,out] Data A pointer to the source of the serialized data. After serialization, the pointer will be adjusted by the size of the data read.
+     * @return The deserialized value.
+     */
+    template <std::endian _E, Serializable _T>
+    __forceinline _T Deserialize(const void*& Data);
+    /**
+     * @brief Deserializes a value with the given byte order.
+     * @tparam _E The byte order of the serialized data. std::endian::native performs no conversion, and is appropriate only when both ends share an architecture.
+     * @tparam _T The type of the value deserialized. _T must conform to BSerializer::Serializable.
+     * @param[in,out] Data A pointer to the source of the serialized data. After serialization, the pointer will be adjusted by the size of the data read.
+     * @param[out] Value A pointer to the location in memory in which the deserialized value will be placed.
+     */
+    template <std::endian _E, Serializable _T>
+    __forceinline void Deserialize(const void*& Data, _T* Value);
+    /**
+     * @brief Deserializes a value with the given byte order.
+     * @tparam _E The byte order of the serialized data. std::endian::native performs no conversion, and is appropriate only when both ends share an architecture.
+     * @tparam _T The type of the value deserialized. _T must conform to BSerializer::Serializable.
+     * @param[in,out] Data A pointer to the source of the serialized data. After serialization, the pointer will be adjusted by the size of the data read.
+     * @param[out] Value A pointer to the location in memory in which the deserialized value will be placed.
+     */
+    template <std::endian _E, Serializable _T>
+    __forceinline void Deserialize(const void*& Data, void* Value);
+    /**
+     * @brief Deserializes a value with the given byte order.
+     * @tparam _E The byte order of the serialized data. std::endian::native performs no conversion, and is appropriate only when both ends share an architecture.
+     * @tparam _T The type of the value deserialized. _T must conform to BSerializer::Serializable.
+     * @param Data A pointer to the source of the serialized data. After serialization, the pointer will be adjusted by the size of the data read.
+     * @return The deserialized value.
+     */
+    template <std::endian _E, Serializable _T>
+    __forceinline _T Deserialize(void*& Data);
+    /**
+     * @brief Deserializes a value with the given byte order.
+     * @tparam _E The byte order of the serialized data. std::endian::native performs no conversion, and is appropriate only when both ends share an architecture.
+     * @tparam _T The type of the value deserialized. _T must conform to BSerializer::Serializable.
+     * @param[in,out] Data A pointer to the source of the serialized data. After serialization, the pointer will be adjusted by the size of the data read.
+     * @param[out] Value A pointer to the location in memory in which the deserialized value will be placed.
+     */
+    template <std::endian _E, Serializable _T>
+    __forceinline void Deserialize(void*& Data, _T* Value);
+    /**
+     * @brief Deserializes a value with the given byte order.
+     * @tparam _E The byte order of the serialized data. std::endian::native performs no conversion, and is appropriate only when both ends share an architecture.
+     * @tparam _T The type of the value deserialized. _T must conform to BSerializer::Serializable.
+     * @param[in,out] Data A pointer to the source of the serialized data. After serialization, the pointer will be adjusted by the size of the data read.
+     * @param[out] Value A pointer to the location in memory in which the deserialized value will be placed.
+     */
+    template <std::endian _E, Serializable _T>
+    __forceinline void Deserialize(void*& Data, void* Value);
+
     /**
      * @brief Returns what the serialized size of an array of values in memory would be if it were serialized.
      * @tparam _T The type of the array elements. _T must conform to BSerializer::Serializable.
@@ -200,6 +427,165 @@ namespace BSerializer {
      */
     template <Serializable _T>
     __forceinline void DeserializeArray(const void*& Data, _T* Array, size_t Length);
+    /**
+     * @brief Serializes an array of values with the given byte order.
+     * @tparam _E The byte order of the serialized data. std::endian::native performs no conversion, and is appropriate only when both ends share an architecture.
+     * @tparam _T The type of the array elements. _T must conform to BSerializer::Serializable.
+     * @param[out] Data A pointer to the destination of the serialized data. After serialization, the pointer will be adjusted by the size of the data written.
+     * @param[in] Lower A pointer to the inclusive lower bound of the array.
+     * @param[in] Upper A pointer to the exclusive upper bound of the array.
+     */
+    template <std::endian _E, Serializable _T>
+    __forceinline void SerializeArray(void*& Data, const _T* Lower, const _T* Upper);
+    /**
+     * @brief Serializes an array of values with the given byte order.
+     * @tparam _E The byte order of the serialized data. std::endian::native performs no conversion, and is appropriate only when both ends share an architecture.
+     * @tparam _T The type of the array elements. _T must conform to BSerializer::Serializable.
+     * @param[out] Data A pointer to the destination of the serialized data. After serialization, the pointer will be adjusted by the size of the data written.
+     * @param[in] Array A pointer to the inclusive lower bound of the array.
+     * @param[in] Length The quantity of elements in the array.
+     */
+    template <std::endian _E, Serializable _T>
+    __forceinline void SerializeArray(void*& Data, const _T* Array, size_t Length);
+    /**
+     * @brief Deserializes an array of values with the given byte order.
+     * @tparam _E The byte order of the serialized data. std::endian::native performs no conversion, and is appropriate only when both ends share an architecture.
+     * @tparam _T The type of the array elements. _T must conform to BSerializer::Serializable.
+     * @param[in,out] Data A pointer to the source of the serialized data. After serialization, the pointer will be adjusted by the size of the data read.
+     * @param[out] Lower A pointer to the inclusive lower bound of the array.
+     * @param[out] Upper A pointer to the exclusive upper bound of the array.
+     */
+    template <std::endian _E, Serializable _T>
+    __forceinline void DeserializeArray(const void*& Data, _T* Lower, _T* Upper);
+    /**
+     * @brief Deserializes an array of values with the given byte order.
+     * @tparam _E The byte order of the serialized data. std::endian::native performs no conversion, and is appropriate only when both ends share an architecture.
+     * @tparam _T The type of the array elements. _T must conform to BSerializer::Serializable.
+     * @param[in,out] Data A pointer to the source of the serialized data. After serialization, the pointer will be adjusted by the size of the data read.
+     * @param[out] Array A pointer to the inclusive lower bound of the array.
+     * @param[in] Length The quantity of elements in the array.
+     */
+    template <std::endian _E, Serializable _T>
+    __forceinline void DeserializeArray(const void*& Data, _T* Array, size_t Length);
+
+    /**
+     * @brief Deserializes the elements of a serialized collection one at a time, passing each to a callback instead of materializing the collection.
+     *
+     * At most one element is held in memory at a time. If _T satisfies BSerializer::SerializableMap and the callback is invocable with an rvalue key and an rvalue mapped value, each key/value pair is passed as two arguments; otherwise each element is passed as a single rvalue of type `_T::value_type`.
+     * @tparam _T The type of the serialized collection. _T must conform to BSerializer::SerializableCollection.
+     * @tparam _TFunc The type of the callback.
+     * @param[in,out] Data A pointer to the source of the serialized data. After deserialization, the pointer will be adjusted by the size of the data read.
+     * @param[in] Callback The callback invoked for each element, in serialized order.
+     */
+    template <SerializableCollection _T, typename _TFunc>
+    __forceinline void ForEachSerialized(const void*& Data, _TFunc&& Callback);
+    /**
+     * @brief Deserializes the elements of a serialized collection one at a time, passing each to a callback instead of materializing the collection.
+     *
+     * At most one element is held in memory at a time. If _T satisfies BSerializer::SerializableMap and the callback is invocable with an rvalue key and an rvalue mapped value, each key/value pair is passed as two arguments; otherwise each element is passed as a single rvalue of type `_T::value_type`.
+     * @tparam _T The type of the serialized collection. _T must conform to BSerializer::SerializableCollection.
+     * @tparam _TFunc The type of the callback.
+     * @param[in,out] Data A pointer to the source of the serialized data. After deserialization, the pointer will be adjusted by the size of the data read.
+     * @param[in] Callback The callback invoked for each element, in serialized order.
+     */
+    template <SerializableCollection _T, typename _TFunc>
+    __forceinline void ForEachSerialized(void*& Data, _TFunc&& Callback);
+    /**
+     * @brief Deserializes the elements of a serialized collection directly into an output iterator, without constructing a collection.
+     * @tparam _T The type of the elements. _T must conform to BSerializer::Serializable.
+     * @tparam _TIt The type of the output iterator.
+     * @param[in,out] Data A pointer to the source of the serialized data. After deserialization, the pointer will be adjusted by the size of the data read.
+     * @param[in] Out The iterator to which the elements are written, in serialized order.
+     * @return The iterator one past the last element written.
+     */
+    template <Serializable _T, std::output_iterator<_T> _TIt>
+    __forceinline _TIt DeserializeTo(const void*& Data, _TIt Out);
+    /**
+     * @brief Deserializes the elements of a serialized collection directly into an output iterator, without constructing a collection.
+     * @tparam _T The type of the elements. _T must conform to BSerializer::Serializable.
+     * @tparam _TIt The type of the output iterator.
+     * @param[in,out] Data A pointer to the source of the serialized data. After deserialization, the pointer will be adjusted by the size of the data read.
+     * @param[in] Out The iterator to which the elements are written, in serialized order.
+     * @return The iterator one past the last element written.
+     */
+    template <Serializable _T, std::output_iterator<_T> _TIt>
+    __forceinline _TIt DeserializeTo(void*& Data, _TIt Out);
+    /**
+     * @brief Deserializes the elements of a serialized collection with the given byte order, one at a time, passing each to a callback instead of materializing the collection.
+     * @tparam _E The byte order of the serialized data. std::endian::native performs no conversion, and is appropriate only when both ends share an architecture.
+     * @tparam _T The type of the serialized collection. _T must conform to BSerializer::SerializableCollection.
+     * @tparam _TFunc The type of the callback.
+     * @param[in,out] Data A pointer to the source of the serialized data. After deserialization, the pointer will be adjusted by the size of the data read.
+     * @param[in] Callback The callback invoked for each element, in serialized order.
+     */
+    template <std::endian _E, SerializableCollection _T, typename _TFunc>
+    __forceinline void ForEachSerialized(const void*& Data, _TFunc&& Callback);
+    /**
+     * @brief Deserializes the elements of a serialized collection with the given byte order directly into an output iterator, without constructing a collection.
+     * @tparam _E The byte order of the serialized data. std::endian::native performs no conversion, and is appropriate only when both ends share an architecture.
+     * @tparam _T The type of the elements. _T must conform to BSerializer::Serializable.
+     * @tparam _TIt The type of the output iterator.
+     * @param[in,out] Data A pointer to the source of the serialized data. After deserialization, the pointer will be adjusted by the size of the data read.
+     * @param[in] Out The iterator to which the elements are written, in serialized order.
+     * @return The iterator one past the last element written.
+     */
+    template <std::endian _E, Serializable _T, std::output_iterator<_T> _TIt>
+    __forceinline _TIt DeserializeTo(const void*& Data, _TIt Out);
+
+    /**
+     * @brief Returns what the serialized size of a range would be if it were serialized with BSerializer::SerializeRange.
+     * @tparam _TRange The type of the range. _TRange must conform to BSerializer::SerializableRange, and must either be a forward range or be sized with arithmetic elements.
+     * @param[in] Range The range whose serialized size will be precalculated.
+     * @return What the serialized size of the range would be if it were serialized.
+     */
+    template <SerializableRange _TRange>
+        requires std::ranges::forward_range<_TRange> || (std::ranges::sized_range<_TRange> && Arithmetic<std::ranges::range_value_t<_TRange>>)
+    __forceinline size_t SerializedRangeSize(_TRange&& Range);
+    /**
+     * @brief Serializes the elements of a range, in the same format as a collection of those elements.
+     *
+     * The output can be deserialized as any BSerializer::SerializableCollection of the range's value type. If the range is not sized, it is traversed once and the length prefix is written after the elements.
+     * The buffer must hold BSerializer::SerializedRangeSize(Range) bytes, so the range must be sized or traversable more than once. Use the overload taking an end pointer for other ranges, or whenever the size of the output is not known in advance.
+     * @tparam _TRange The type of the range. _TRange must conform to BSerializer::SerializableRange, and must be a forward range or a sized range.
+     * @param[out] Data A pointer to the destination of the serialized data. After serialization, the pointer will be adjusted by the size of the data written.
+     * @param[in] Range The range to serialize.
+     */
+    template <SerializableRange _TRange>
+        requires std::ranges::forward_range<_TRange> || std::ranges::sized_range<_TRange>
+    __forceinline void SerializeRange(void*& Data, _TRange&& Range);
+    /**
+     * @brief Serializes the elements of a range with the given byte order, in the same format as a collection of those elements.
+     * @tparam _E The byte order of the serialized data. std::endian::native performs no conversion, and is appropriate only when both ends share an architecture.
+     * @tparam _TRange The type of the range. _TRange must conform to BSerializer::SerializableRange, and must be a forward range or a sized range.
+     * @param[out] Data A pointer to the destination of the serialized data. After serialization, the pointer will be adjusted by the size of the data written.
+     * @param[in] Range The range to serialize.
+     */
+    template <std::endian _E, SerializableRange _TRange>
+        requires std::ranges::forward_range<_TRange> || std::ranges::sized_range<_TRange>
+    __forceinline void SerializeRange(void*& Data, _TRange&& Range);
+    /**
+     * @brief Serializes the elements of any range into a bounded buffer, in the same format as a collection of those elements.
+     *
+     * Before each element is written, its serialized size is checked against the space that remains before End. If the range does not fit, std::out_of_range is thrown and Data is left unchanged; the bytes before End may have been overwritten.
+     * @tparam _TRange The type of the range. _TRange must conform to BSerializer::SerializableRange.
+     * @param[out] Data A pointer to the destination of the serialized data. After serialization, the pointer will be adjusted by the size of the data written.
+     * @param[in] End A pointer to the end of the destination buffer.
+     * @param[in] Range The range to serialize.
+     * @exception std::out_of_range Thrown if the serialized range does not fit before End.
+     */
+    template <SerializableRange _TRange>
+    __forceinline void SerializeRange(void*& Data, const void* End, _TRange&& Range);
+    /**
+     * @brief Serializes the elements of any range with the given byte order into a bounded buffer, in the same format as a collection of those elements.
+     * @tparam _E The byte order of the serialized data. std::endian::native performs no conversion, and is appropriate only when both ends share an architecture.
+     * @tparam _TRange The type of the range. _TRange must conform to BSerializer::SerializableRange.
+     * @param[out] Data A pointer to the destination of the serialized data. After serialization, the pointer will be adjusted by the size of the data written.
+     * @param[in] End A pointer to the end of the destination buffer.
+     * @param[in] Range The range to serialize.
+     * @exception std::out_of_range Thrown if the serialized range does not fit before End.
+     */
+    template <std::endian _E, SerializableRange _TRange>
+    __forceinline void SerializeRange(void*& Data, const void* End, _TRange&& Range);
 
     /**
      * @brief Returns the size of the raw serialized data. After serialization, the pointer will be adjusted by the size of the data written.
@@ -277,6 +663,20 @@ namespace BSerializer {
      * @param[in] Length The quantity of elements in the array.
      */
     __forceinline void DeserializeRaw(const void*& Data, void* Lower, size_t Length);
+
+    /**
+     * @brief Sets the size above which raw copies bypass the cache. Copies of at least this many bytes are written with non-temporal stores, so that very large values do not evict the rest of the working set; the source of a deserialized copy is also prefetched without polluting the cache.
+     *
+     * The default, 16 MiB, comes from BSerializer::BenchmarkStreamingThreshold. On the x86-64 machine it was measured on (2 MiB L2 cache, 105 MiB L3 cache, 1 MiB working set), copies of 16 MiB and more were cheaper with non-temporal stores in every run, counting both the copy and the reload of the working set. Between 1 MiB and 8 MiB the outcome varied from run to run, and below 1 MiB non-temporal stores always lost.
+     * Run the benchmark, and pass BSerializer::SuggestStreamingThreshold of its results, to tune the threshold for another machine.
+     * @param[in] Threshold The minimum size, in bytes, of a copy that bypasses the cache. SIZE_MAX disables non-temporal stores entirely. The default is 16 MiB.
+     */
+    __forceinline void SetStreamingThreshold(size_t Threshold);
+    /**
+     * @brief Returns the size above which raw copies bypass the cache.
+     * @return The minimum size, in bytes, of a copy that bypasses the cache.
+     */
+    __forceinline size_t StreamingThreshold();
 }
 
 template <typename _T>
@@ -290,94 +690,97 @@ __forceinline void BSerializer::details::byteSwap(_T& Bytes) {
     std::reverse(bytes, bytes + sizeof(_T));
 }
 
-template <typename _TTuple, size_t _Index, typename _TFirst, typename... _TsAll>
-__forceinline void BSerializer::details::tupleDeserializer2<_TTuple, _Index, _TFirst, _TsAll...>::DeserializeTuple(const void*& Data, _TTuple& Tuple) {
-    _TFirst& v = std::get<_Index>(Tuple);
-    Deserialize<_TFirst>(Data, &v);
-    if constexpr (sizeof...(_TsAll)) {
-        tupleDeserializer2<_TTuple, _Index + 1, _TsAll...>::DeserializeTuple(Data, Tuple);
-    }
+template <typename _T>
+__forceinline BSerializer::details::decodeScratch<_T>::decodeScratch(size_t Count)
+    : buffer(sizeof(_T) * Count), lower((_T*)buffer.Data()), upper(lower) { }
+
+template <typename _T>
+__forceinline BSerializer::details::decodeScratch<_T>::~decodeScratch() {
+    std::destroy(lower, upper);
 }
 
-template <typename _TTuple>
+template <std::endian _E, typename _TTuple>
 __forceinline static void BSerializer::details::DeserializeTuple(const void*& Data, _TTuple& Tuple) {
-    tupleDeserializer<_TTuple>::DeserializeTuple(Data, Tuple);
+    std::apply([&Data](auto&... Elements) {
+        (Deserialize<_E, std::remove_reference_t<decltype(Elements)>>(Data, &Elements), ...);
+    }, Tuple);
 }
 
-template <size_t _Index, typename... _Ts>
-size_t BSerializer::details::variantHelper2<_Index, _Ts...>::SerializedSize(const std::variant<_Ts...>& Variant) {
-    if constexpr (_Index >= sizeof...(_Ts)) {
-        if constexpr ((std::same_as<std::monostate, _Ts> || ...)) return sizeof(size_t);
-        else throw std::out_of_range("Index of 'std::variant<...>' is out of bounds; parameter 'Variant' is invalid.");
-    }
-    else if (Variant.index() == _Index) {
-        using element_t = std::tuple_element_t<_Index, std::tuple<_Ts...>>;
-        if constexpr (std::same_as<element_t, std::monostate>) return sizeof(size_t);
-        else return sizeof(size_t) + BSerializer::SerializedSize(std::get<_Index>(Variant));
-    }
-    else {
-        return variantHelper2<_Index + 1, _Ts...>::SerializedSize(Variant);
-    }
+template <size_t _Index, typename _TVariant>
+size_t BSerializer::details::variantAlternativeSize(const _TVariant& Variant) {
+    using element_t = std::variant_alternative_t<_Index, _TVariant>;
+    if constexpr (std::same_as<element_t, std::monostate>) return sizeof(size_t);
+    else return sizeof(size_t) + BSerializer::SerializedSize(*std::get_if<_Index>(&Variant));
 }
 
-template <size_t _Index, typename... _Ts>
-void BSerializer::details::variantHelper2<_Index, _Ts...>::Serialize(void*& Data, const std::variant<_Ts...>& Variant) {
-    if constexpr (_Index >= sizeof...(_Ts)) {
-        if constexpr ((std::same_as<std::monostate, _Ts> || ...)) {
-            BSerializer::Serialize(Data, (size_t)0 - (size_t)1);
-        }
-        else throw std::out_of_range("Index of 'std::variant<...>' is out of bounds; parameter 'Variant' is invalid.");
-    }
-    else if (Variant.index() == _Index) {
-        using element_t = std::tuple_element_t<_Index, std::tuple<_Ts...>>;
-        BSerializer::Serialize(Data, _Index);
-        if constexpr (!std::same_as<element_t, std::monostate>) {
-            BSerializer::Serialize(Data, std::get<_Index>(Variant));
-        }
-    }
-    else {
-        variantHelper2<_Index + 1, _Ts...>::Serialize(Data, Variant);
+template <std::endian _E, size_t _Index, typename _TVariant>
+void BSerializer::details::variantAlternativeSerialize(void*& Data, const _TVariant& Variant) {
+    using element_t = std::variant_alternative_t<_Index, _TVariant>;
+    BSerializer::Serialize<_E>(Data, _Index);
+    if constexpr (!std::same_as<element_t, std::monostate>) {
+        BSerializer::Serialize<_E>(Data, *std::get_if<_Index>(&Variant));
     }
 }
 
-template <size_t _Index, typename... _Ts>
-void BSerializer::details::variantHelper2<_Index, _Ts...>::Deserialize(const void*& Data, size_t Index, std::variant<_Ts...>* Variant) {
-    if constexpr (_Index >= sizeof...(_Ts)) {
-        if constexpr ((std::same_as<std::monostate, _Ts> || ...)) {
-            new (Variant) std::variant<_Ts...>(std::monostate());
-        }
-        else {
-            throw std::out_of_range("Deserialized index is out of bounds.");
-        }
-    }
-    else if (Index == _Index) {
-        using element_t = std::tuple_element_t<_Index, std::tuple<_Ts...>>;
-        if constexpr (std::same_as<element_t, std::monostate>) {
-            new (Variant) std::variant<_Ts...>(std::monostate());
-        }
-        else {
-            new (Variant) std::variant<_Ts...>(BSerializer::Deserialize<element_t>(Data));
-        }
+template <std::endian _E, size_t _Index, typename _TVariant>
+void BSerializer::details::variantAlternativeDeserialize(const void*& Data, _TVariant* Variant) {
+    using element_t = std::variant_alternative_t<_Index, _TVariant>;
+    if constexpr (std::same_as<element_t, std::monostate>) {
+        new (Variant) _TVariant(std::in_place_index<_Index>);
     }
     else {
-        variantHelper2<_Index + 1, _Ts...>::Deserialize(Data, Index, Variant);
+        new (Variant) _TVariant(std::in_place_index<_Index>, BSerializer::Deserialize<_E, element_t>(Data));
     }
 }
 
 template <typename _TVariant>
 size_t BSerializer::details::variantSerializedSize(const _TVariant& Variant) {
-    return variantHelper<_TVariant>::SerializedSize(Variant);
+    size_t idx = Variant.index();
+    if (idx >= std::variant_size_v<_TVariant>) [[unlikely]] {
+        if constexpr (variantHasMonostate<_TVariant>) return sizeof(size_t);
+        else throwOutOfRange("Index of 'std::variant<...>' is out of bounds; parameter 'Variant' is invalid.");
+    }
+    return [idx, &Variant]<size_t... _Indices>(std::index_sequence<_Indices...>) {
+        constexpr size_t (*table[])(const _TVariant&) = { &variantAlternativeSize<_Indices, _TVariant>... };
+        return table[idx](Variant);
+    }(std::make_index_sequence<std::variant_size_v<_TVariant>>());
 }
 
-template <typename _TVariant>
+template <std::endian _E, typename _TVariant>
 void BSerializer::details::variantSerialize(void*& Data, const _TVariant& Variant) {
-    variantHelper<_TVariant>::Serialize(Data, Variant);
+    size_t idx = Variant.index();
+    if (idx >= std::variant_size_v<_TVariant>) [[unlikely]] {
+        if constexpr (variantHasMonostate<_TVariant>) BSerializer::Serialize<_E>(Data, (size_t)0 - (size_t)1);
+        else throwOutOfRange("Index of 'std::variant<...>' is out of bounds; parameter 'Variant' is invalid.");
+        return;
+    }
+    [idx, &Data, &Variant]<size_t... _Indices>(std::index_sequence<_Indices...>) {
+        constexpr void (*table[])(void*&, const _TVariant&) = { &variantAlternativeSerialize<_E, _Indices, _TVariant>... };
+        table[idx](Data, Variant);
+    }(std::make_index_sequence<std::variant_size_v<_TVariant>>());
 }
 
-template <typename _TVariant>
+template <std::endian _E, typename _TVariant>
 void BSerializer::details::variantDeserialize(const void*& Data, _TVariant* Variant) {
-    size_t idx = BSerializer::Deserialize<size_t>(Data);
-    variantHelper<_TVariant>::Deserialize(Data, idx, Variant);
+    size_t idx = BSerializer::Deserialize<_E, size_t>(Data);
+    if (idx >= std::variant_size_v<_TVariant>) [[unlikely]] {
+        if constexpr (variantHasMonostate<_TVariant>) new (Variant) _TVariant(std::monostate());
+        else throwOutOfRange("Deserialized index is out of bounds.");
+        return;
+    }
+    [idx, &Data, Variant]<size_t... _Indices>(std::index_sequence<_Indices...>) {
+        constexpr void (*table[])(const void*&, _TVariant*) = { &variantAlternativeDeserialize<_E, _Indices, _TVariant>... };
+        table[idx](Data, Variant);
+    }(std::make_index_sequence<std::variant_size_v<_TVariant>>());
+}
+
+inline void BSerializer::details::throwOutOfRange(const char* Message) {
+#if defined(__cpp_exceptions) || defined(_CPPUNWIND)
+    throw std::out_of_range(Message);
+#else
+    (void)Message;
+    std::abort();
+#endif
 }
 
 template <typename _T>
@@ -400,8 +803,56 @@ __forceinline void BSerializer::ToFromLittleEndian(_T* Array, size_t Length) {
     ToFromLittleEndian(Array, Array + Length);
 }
 
+template <std::endian _E, typename _T>
+__forceinline _T BSerializer::ToFromEndian(_T Value) {
+    if constexpr (_E != std::endian::native) details::byteSwap(Value);
+    return Value;
+}
+
+template <std::endian _E>
+__forceinline void BSerializer::SerializeWireHeader(void*& Data) {
+    uint8_t* bytes = (uint8_t*)Data;
+    bytes[0] = 'B';
+    bytes[1] = 'S';
+    bytes[2] = 'E';
+    bytes[3] = 'R';
+    bytes[4] = _E == std::endian::big ? 1 : 0;
+    bytes[5] = (uint8_t)sizeof(size_t);
+    bytes[6] = 0;
+    bytes[7] = 0;
+    Data = bytes + WireHeaderSize;
+}
+
+template <std::endian _E>
+__forceinline bool BSerializer::CheckWireHeader(const void*& Data) {
+    const uint8_t* bytes = (const uint8_t*)Data;
+    if (bytes[0] != 'B' || bytes[1] != 'S' || bytes[2] != 'E' || bytes[3] != 'R') return false;
+    if (bytes[4] != (_E == std::endian::big ? 1 : 0)) return false;
+    if (bytes[5] != sizeof(size_t)) return false;
+    Data = bytes + WireHeaderSize;
+    return true;
+}
+
 template <BSerializer::Serializable _T>
 __forceinline size_t BSerializer::SerializedSize(const _T& Value) {
+    BSERIALIZER_INSTRUMENT_SCOPE(_T, SerializedSize);
+    if constexpr (Arithmetic<_T>) {
+        return sizeof(_T);
+    }
+    else if constexpr (StdComplex<_T>) {
+        return sizeof(decltype(Value.real())) << 1;
+    }
+    else if constexpr (StdDuration<_T>) {
+        return sizeof(decltype(Value.count()));
+    }
+    else if constexpr (StdTimePoint<_T>) {
+        return sizeof(decltype(Value.time_since_epoch().count()));
+    }
+    else return details::serializedSizeComposite(Value);
+}
+
+template <typename _T>
+BSERIALIZER_COMPOSITE size_t BSerializer::details::serializedSizeComposite(const _T& Value) {
     if constexpr (BuiltInSerializable<_T>) {
         return Value.SerializedSize();
     }
@@ -413,16 +864,16 @@ __forceinline size_t BSerializer::SerializedSize(const _T& Value) {
             t += s >> 3;
             if (s & 7) t += 1;
         }
+        else if constexpr (Arithmetic<value_t>) {
+            t += sizeof(value_t) * Value.size();
+        }
         else {
-            for (auto& v : Value) {
+            details::forEachPrefetched(Value, [&t](const value_t& v) {
                 t += SerializedSize(v);
-            }
+            });
         }
         return t;
     }
-    else if constexpr (Arithmetic<_T>) {
-        return sizeof(_T);
-    }
     else if constexpr (SerializableStdPair<_T>) {
         return
             SerializedSize(Value.first) +
@@ -435,9 +886,6 @@ __forceinline size_t BSerializer::SerializedSize(const _T& Value) {
         }, Value);
         return t;
     }
-    else if constexpr (StdComplex<_T>) {
-        return sizeof(decltype(Value.real())) << 1;
-    }
     else if constexpr (SerializableStdArray<_T>) {
         size_t t = 0;
         for (auto& e : Value) t += SerializedSize(e);
@@ -452,23 +900,74 @@ __forceinline size_t BSerializer::SerializedSize(const _T& Value) {
     else if constexpr (SerializableStdVariant<_T>) {
         return details::variantSerializedSize(Value);
     }
+}
+
+template <BSerializer::Serializable _T>
+__forceinline void BSerializer::Serialize(void*& Data, const _T& Value) {
+    Serialize<std::endian::little>(Data, Value);
+}
+
+template <BSerializer::Serializable _T>
+__forceinline _T BSerializer::Deserialize(const void*& Data) {
+    return Deserialize<std::endian::little, _T>(Data);
+}
+
+template <BSerializer::Serializable _T>
+__forceinline void BSerializer::Deserialize(const void*& Data, _T* Value) {
+    Deserialize<std::endian::little, _T>(Data, Value);
+}
+
+template <BSerializer::Serializable _T>
+__forceinline void BSerializer::Deserialize(const void*& Data, void* Value) {
+    Deserialize<std::endian::little, _T>(Data, Value);
+}
+
+template <BSerializer::Serializable _T>
+__forceinline _T BSerializer::Deserialize(void*& Data) {
+    return Deserialize<std::endian::little, _T>(Data);
+}
+
+template <BSerializer::Serializable _T>
+__forceinline void BSerializer::Deserialize(void*& Data, _T* Value) {
+    Deserialize<std::endian::little, _T>(Data, Value);
+}
+
+template <BSerializer::Serializable _T>
+__forceinline void BSerializer::Deserialize(void*& Data, void* Value) {
+    Deserialize<std::endian::little, _T>(Data, Value);
+}
+
+template <std::endian _E, BSerializer::Serializable _T>
+__forceinline void BSerializer::Serialize(void*& Data, const _T& Value) {
+    BSERIALIZER_INSTRUMENT_SCOPE(_T, Serialize, Data);
+    BSERIALIZER_PROBE_SCOPE(_T, false, Data);
+    if constexpr (Arithmetic<_T>) {
+        _T v2 = ToFromEndian<_E>(Value);
+        memcpy(Data, &v2, sizeof(_T));
+        Data = ((_T*)Data + 1);
+    }
+    else if constexpr (StdComplex<_T>) {
+        Serialize<_E>(Data, Value.real());
+        Serialize<_E>(Data, Value.imag());
+    }
     else if constexpr (StdDuration<_T>) {
-        return sizeof(decltype(Value.count()));
+        Serialize<_E>(Data, Value.count());
     }
     else if constexpr (StdTimePoint<_T>) {
-        return sizeof(decltype(Value.time_since_epoch().count()));
+        Serialize<_E>(Data, Value.time_since_epoch());
     }
+    else details::serializeComposite<_E>(Data, Value);
 }
 
-template <BSerializer::Serializable _T>
-__forceinline void BSerializer::Serialize(void*& Data, const _T& Value) {
+template <std::endian _E, typename _T>
+BSERIALIZER_COMPOSITE void BSerializer::details::serializeComposite(void*& Data, const _T& Value) {
     if constexpr (BuiltInSerializable<_T>) {
         Value.Serialize(Data);
     }
     else if constexpr (SerializableCollection<_T>) {
         using value_t = typename _T::value_type;
         size_t len = Value.size();
-        Serialize(Data, len);
+        Serialize<_E>(Data, len);
         if (len) {
             if constexpr (std::same_as<value_t, bool>) {
                 uint64_t m = 1;
@@ -476,7 +975,7 @@ __forceinline void BSerializer::Serialize(void*& Data, const _T& Value) {
                 if constexpr (std::same_as<decltype(*Value.cbegin()), bool>) {
                     for (bool v : Value) {
                         if (!m) {
-                            Serialize(Data, c);
+                            Serialize<std::endian::little>(Data, c);
                             m = 1;
                             c = 0;
                         }
@@ -487,7 +986,7 @@ __forceinline void BSerializer::Serialize(void*& Data, const _T& Value) {
                 else {
                     for (auto& v : Value) {
                         if (!m) {
-                            Serialize(Data, c);
+                            Serialize<std::endian::little>(Data, c);
                             m = 1;
                             c = 0;
                         }
@@ -496,103 +995,121 @@ __forceinline void BSerializer::Serialize(void*& Data, const _T& Value) {
                     }
                 }
                 if (m) {
-                    size_t i;
-                    if (!(c >> 8)) i = 1;
-                    else if (!(c >> 16)) i = 2;
-                    else if (!(c >> 24)) i = 3;
-                    else if (!(c >> 32)) i = 4;
-                    else if (!(c >> 40)) i = 5;
-                    else if (!(c >> 48)) i = 6;
-                    else if (!(c >> 56)) i = 7;
-                    else i = 8;
-                    if constexpr (std::endian::native == std::endian::big) std::reverse((uint8_t*)&c, ((uint8_t*)&c) + i);
+                    size_t i = ((len & 63) + 7) >> 3;
+                    c = ToFromLittleEndian(c);
                     memcpy(Data, &c, i);
                     Data = ((uint8_t*)Data) + i;
                 }
-                else Serialize(Data, c);
+                else Serialize<std::endian::little>(Data, c);
             }
-            else for (auto& v : Value) Serialize(Data, v);
+            else if constexpr (Arithmetic<value_t> && std::contiguous_iterator<typename _T::const_iterator> && _E == std::endian::native) {
+                SerializeRaw(Data, std::to_address(Value.cbegin()), sizeof(value_t) * len);
+            }
+            else details::forEachPrefetched(Value, [&Data](const value_t& v) {
+                Serialize<_E>(Data, v);
+            });
         }
     }
-    else if constexpr (Arithmetic<_T>) {
-        _T v2 = ToFromLittleEndian(Value);
-        memcpy(Data, &v2, sizeof(_T));
-        Data = ((_T*)Data + 1);
-    }
     else if constexpr (SerializableStdPair<_T>) {
-        Serialize(Data, Value.first);
-        Serialize(Data, Value.second);
+        Serialize<_E>(Data, Value.first);
+        Serialize<_E>(Data, Value.second);
     }
     else if constexpr (SerializableStdTuple<_T>) {
         std::apply([&Data](const auto&... args) {
-            (Serialize(Data, args), ...);
+            (Serialize<_E>(Data, args), ...);
         }, Value);
     }
-    else if constexpr (StdComplex<_T>) {
-        Serialize(Data, Value.real());
-        Serialize(Data, Value.imag());
-    }
     else if constexpr (SerializableStdArray<_T>) {
-        for (auto& e : Value) Serialize(Data, e);
+        if constexpr (Arithmetic<typename _T::value_type> && !std::same_as<typename _T::value_type, bool> && _E == std::endian::native) {
+            SerializeRaw(Data, Value.data(), sizeof(_T));
+        }
+        else for (auto& e : Value) Serialize<_E>(Data, e);
     }
     else if constexpr (SerializableStdOptional<_T>) {
         if (Value) {
-            Serialize(Data, true);
-            Serialize(Data, *Value);
+            Serialize<_E>(Data, true);
+            Serialize<_E>(Data, *Value);
         }
-        else Serialize(Data, false);
+        else Serialize<_E>(Data, false);
     }
     else if constexpr (SerializableStdVariant<_T>) {
-        details::variantSerialize(Data, Value);
-    }
-    else if constexpr (StdDuration<_T>) {
-        Serialize(Data, Value.count());
-    }
-    else if constexpr (StdTimePoint<_T>) {
-        Serialize(Data, Value.time_since_epoch());
+        details::variantSerialize<_E>(Data, Value);
     }
 }
 
-template <BSerializer::Serializable _T>
+template <std::endian _E, BSerializer::Serializable _T>
 __forceinline _T BSerializer::Deserialize(const void*& Data) {
-    uint8_t bytes[sizeof(_T)];
-    _T& r = *(_T*)bytes;
-    Deserialize(Data, &r);
+    using value_t = std::remove_cv_t<_T>;
+    alignas(value_t) uint8_t bytes[sizeof(value_t)];
+    value_t* p_v = (value_t*)bytes;
+    Deserialize<_E>(Data, p_v);
+    value_t r(std::move(*p_v));
+    p_v->~value_t();
     return r;
 }
 
-template <BSerializer::Serializable _T>
+template <std::endian _E, BSerializer::Serializable _T>
 __forceinline void BSerializer::Deserialize(const void*& Data, _T* Value) {
-    Deserialize<_T>(Data, *(void**)&Value);
+    Deserialize<_E, _T>(Data, *(void**)&Value);
 }
 
-template <BSerializer::Serializable _T>
+template <std::endian _E, BSerializer::Serializable _T>
 __forceinline void BSerializer::Deserialize(const void*& Data, void* Value) {
+    BSERIALIZER_INSTRUMENT_SCOPE(_T, Deserialize, Data);
+    BSERIALIZER_PROBE_SCOPE(_T, true, Data);
+    if constexpr (Arithmetic<_T>) {
+        new (Value) _T(ToFromEndian<_E>(*(_T*)Data));
+        Data = ((_T*)Data) + 1;
+    }
+    else if constexpr (StdComplex<_T>) {
+        using component_t = decltype(std::declval<_T>().real());
+        component_t re = Deserialize<_E, component_t>(Data);
+        component_t im = Deserialize<_E, component_t>(Data);
+        new (Value) _T(re, im);
+    }
+    else if constexpr (StdDuration<_T>) {
+        using internal_t = decltype(std::declval<_T>().count());
+        new (Value) _T(Deserialize<_E, internal_t>(Data));
+    }
+    else if constexpr (StdTimePoint<_T>) {
+        using internal_t = decltype(std::declval<_T>().time_since_epoch());
+        new (Value) _T(Deserialize<_E, internal_t>(Data));
+    }
+    else details::deserializeComposite<_E, _T>(Data, Value);
+}
+
+template <std::endian _E, typename _T>
+BSERIALIZER_COMPOSITE void BSerializer::details::deserializeComposite(const void*& Data, void* Value) {
     if constexpr (BuiltInSerializable<_T>) {
         _T::Deserialize(Data, Value);
     }
     else if constexpr (SerializableCollection<_T>) {
         using value_t = typename _T::value_type;
-        size_t len = Deserialize<size_t>(Data);
-        value_t* arr = (value_t*)malloc(sizeof(value_t) * len);
+        size_t len = Deserialize<_E, size_t>(Data);
+        details::chargeCollection<value_t>(Data, len);
+        BSERIALIZER_PROBE(collection__decode__start, TypeHash<_T>(), len);
+        BSERIALIZER_PROBE(alloc, TypeHash<value_t>(), sizeof(value_t) * len);
+        details::decodeScratch<value_t> scratch(len);
+        value_t* arr = scratch.lower;
         value_t* b = arr + len;
         if constexpr (std::same_as<value_t, bool>) {
-            bool* fb = arr + (len & ~((1ui64 << 6) - 1));
+            bool* fb = arr + (len & ~((UINT64_C(1) << 6) - 1));
             uint64_t m = 0;
             uint64_t c = 0;
             for (bool* p_v = arr; p_v < fb; ++p_v) {
                 if (!m) {
                     m = 1;
-                    Deserialize(Data, &c);
+                    Deserialize<std::endian::little>(Data, &c);
                 }
                 *p_v = (bool)(c & m);
                 m <<= 1;
             }
             if (fb != b) {
                 size_t i = b - fb;
-                i = (i >> 3) + ((i & 7ui64) ? 1ui64 : 0ui64);
+                i = (i >> 3) + ((i & 7) ? 1 : 0);
+                c = 0;
                 memcpy(&c, Data, i);
-                if constexpr (std::endian::native == std::endian::big) std::reverse((uint8_t*)&c, ((uint8_t*)&c) + i);
+                c = ToFromLittleEndian(c);
                 Data = ((uint8_t*)Data) + i;
                 m = 1;
                 for (bool* p_v = fb; p_v < b; ++p_v) {
@@ -601,96 +1118,81 @@ __forceinline void BSerializer::Deserialize(const void*& Data, void* Value) {
                 }
             }
         }
-        else for (value_t* i = arr; i < b; ++i) Deserialize(Data, i);
-        new (Value) _T(std::initializer_list<value_t>(arr, b));
-        free(arr);
-    }
-    else if constexpr (Arithmetic<_T>) {
-        new (Value) _T(ToFromLittleEndian(*(_T*)Data));
-        Data = ((_T*)Data) + 1;
+        else if constexpr (Arithmetic<value_t> && _E == std::endian::native) {
+            DeserializeRaw(Data, arr, sizeof(value_t) * len);
+        }
+        else for (; scratch.upper < b; ++scratch.upper) Deserialize<_E>(Data, scratch.upper);
+        new (Value) _T((const value_t*)arr, (const value_t*)b);
+        BSERIALIZER_PROBE(collection__decode__end, TypeHash<_T>(), len);
     }
     else if constexpr (SerializableStdPair<_T>) {
         using t1_t = _T::first_type;
         using t2_t = _T::second_type;
         if constexpr (sizeof(t1_t) >> 8) {
-            t1_t* p_v1 = (t1_t*)malloc(sizeof(t1_t));
-            t1_t& v1 = *p_v1;
-            Deserialize(Data, p_v1);
+            details::decodeScratch<t1_t> scratch1(1);
+            Deserialize<_E>(Data, scratch1.lower);
+            t1_t& v1 = *scratch1.upper++;
             if constexpr (sizeof(t2_t) >> 8) {
-                t2_t* p_v2 = (t2_t*)malloc(sizeof(t2_t));
-                t2_t& v2 = *p_v2;
-                Deserialize(Data, p_v2);
+                details::decodeScratch<t2_t> scratch2(1);
+                Deserialize<_E>(Data, scratch2.lower);
+                t2_t& v2 = *scratch2.upper++;
                 new (Value) _T(v1, v2);
-                free(p_v2);
             }
             else {
-                t2_t v2 = Deserialize<t2_t>(Data);
+                t2_t v2 = Deserialize<_E, t2_t>(Data);
                 new (Value) _T(v1, v2);
             }
-            free(p_v1);
         }
         else {
-            t1_t v1 = Deserialize<t1_t>(Data);
+            t1_t v1 = Deserialize<_E, t1_t>(Data);
             if constexpr (sizeof(t2_t) >> 8) {
-                t2_t* p_v2 = (t2_t*)malloc(sizeof(t2_t));
-                t2_t& v2 = *p_v2;
-                Deserialize(Data, p_v2);
+                details::decodeScratch<t2_t> scratch2(1);
+                Deserialize<_E>(Data, scratch2.lower);
+                t2_t& v2 = *scratch2.upper++;
                 new (Value) _T(v1, v2);
-                free(p_v2);
             }
             else {
-                t2_t v2 = Deserialize<t2_t>(Data);
+                t2_t v2 = Deserialize<_E, t2_t>(Data);
                 new (Value) _T(v1, v2);
             }
         }
     }
     else if constexpr (SerializableStdTuple<_T>) {
-        details::DeserializeTuple(Data, *(_T*)Value);
-    }
-    else if constexpr (StdComplex<_T>) {
-        using component_t = decltype(std::declval<_T>().real());
-        component_t re = Deserialize<component_t>(Data);
-        component_t im = Deserialize<component_t>(Data);
-        new (Value) _T(re, im);
+        details::DeserializeTuple<_E>(Data, *(_T*)Value);
     }
     else if constexpr (SerializableStdArray<_T>) {
         using value_t = typename _T::value_type;
         constexpr size_t size = std::tuple_size_v<_T>;
         value_t* i = (value_t*)Value;
         value_t* upper = i + size;
-        for (; i < upper; ++i) Deserialize(Data, i);
+        if constexpr (Arithmetic<value_t> && !std::same_as<value_t, bool> && _E == std::endian::native) {
+            DeserializeRaw(Data, i, sizeof(_T));
+        }
+        else for (; i < upper; ++i) Deserialize<_E>(Data, i);
     }
     else if constexpr (SerializableStdOptional<_T>) {
-        bool v = Deserialize<bool>(Data);
-        if (v) new (Value) _T(Deserialize<typename _T::value_type>(Data));
+        bool v = Deserialize<_E, bool>(Data);
+        if (v) new (Value) _T(Deserialize<_E, typename _T::value_type>(Data));
         else new (Value) _T;
     }
     else if constexpr (SerializableStdVariant<_T>) {
-        details::variantDeserialize(Data, (_T*)Value);
-    }
-    else if constexpr (StdDuration<_T>) {
-        using internal_t = decltype(std::declval<_T>().count());
-        new (Value) _T(Deserialize<internal_t>(Data));
-    }
-    else if constexpr (StdTimePoint<_T>) {
-        using internal_t = decltype(std::declval<_T>().time_since_epoch());
-        new (Value) _T(Deserialize<internal_t>(Data));
+        details::variantDeserialize<_E>(Data, (_T*)Value);
     }
 }
 
-template <BSerializer::Serializable _T>
+template <std::endian _E, BSerializer::Serializable _T>
 __forceinline _T BSerializer::Deserialize(void*& Data) {
-    return Deserialize<_T>(const_cast<const void*&>(Data));
+    return Deserialize<_E, _T>(const_cast<const void*&>(Data));
 }
 
-template <BSerializer::Serializable _T>
+template <std::endian _E, BSerializer::Serializable _T>
 __forceinline void BSerializer::Deserialize(void*& Data, _T* Value) {
-    Deserialize(const_cast<const void*&>(Data), Value);
+    Deserialize<_E>(const_cast<const void*&>(Data), Value);
 }
 
-template <BSerializer::Serializable _T>
+template <std::endian _E, BSerializer::Serializable _T>
 __forceinline void BSerializer::Deserialize(void*& Data, void* Value) {
-    Deserialize<_T>(const_cast<const void*&>(Data), Value);
+    Deserialize<_E, _T>(const_cast<const void*&>(Data), Value);
 }
 
 template <BSerializer::Serializable _T>
@@ -707,22 +1209,270 @@ __forceinline size_t BSerializer::SerializedArraySize(const _T* Array, size_t Le
 
 template <BSerializer::Serializable _T>
 __forceinline void BSerializer::SerializeArray(void*& Data, const _T* Lower, const _T* Upper) {
-    for (; Lower < Upper; ++Lower) Serialize(Data, *Lower);
+    SerializeArray<std::endian::little>(Data, Lower, Upper);
 }
 
 template <BSerializer::Serializable _T>
 __forceinline void BSerializer::SerializeArray(void*& Data, const _T* Array, size_t Length) {
-    SerializeArray(Data, Array, Array + Length);
+    SerializeArray<std::endian::little>(Data, Array, Length);
 }
 
 template <BSerializer::Serializable _T>
 __forceinline void BSerializer::DeserializeArray(const void*& Data, _T* Lower, _T* Upper) {
-    for (; Lower < Upper; ++Lower) *Lower = Deserialize<_T>(Data);
+    DeserializeArray<std::endian::little>(Data, Lower, Upper);
 }
 
 template <BSerializer::Serializable _T>
 __forceinline void BSerializer::DeserializeArray(const void*& Data, _T* Array, size_t Length) {
-    DeserializeArray(Data, Array, Array + Length);
+    DeserializeArray<std::endian::little>(Data, Array, Length);
+}
+
+template <std::endian _E, BSerializer::Serializable _T>
+__forceinline void BSerializer::SerializeArray(void*& Data, const _T* Lower, const _T* Upper) {
+    for (; Lower < Upper; ++Lower) Serialize<_E>(Data, *Lower);
+}
+
+template <std::endian _E, BSerializer::Serializable _T>
+__forceinline void BSerializer::SerializeArray(void*& Data, const _T* Array, size_t Length) {
+    SerializeArray<_E>(Data, Array, Array + Length);
+}
+
+template <std::endian _E, BSerializer::Serializable _T>
+__forceinline void BSerializer::DeserializeArray(const void*& Data, _T* Lower, _T* Upper) {
+    for (; Lower < Upper; ++Lower) *Lower = Deserialize<_E, _T>(Data);
+}
+
+template <std::endian _E, BSerializer::Serializable _T>
+__forceinline void BSerializer::DeserializeArray(const void*& Data, _T* Array, size_t Length) {
+    DeserializeArray<_E>(Data, Array, Array + Length);
+}
+
+__forceinline uint64_t BSerializer::details::deserializeBoolChunk(const void*& Data, size_t Remaining) {
+    if (Remaining >= 64) return BSerializer::Deserialize<uint64_t>(Data);
+    size_t i = (Remaining + 7) >> 3;
+    uint64_t c = 0;
+    memcpy(&c, Data, i);
+    Data = ((uint8_t*)Data) + i;
+    return ToFromLittleEndian(c);
+}
+
+template <std::endian _E, typename _T, typename _TFunc>
+__forceinline void BSerializer::details::forEachSerializedElement(const void*& Data, size_t Length, _TFunc& Callback) {
+    if constexpr (std::same_as<_T, bool>) {
+        uint64_t c = 0;
+        for (size_t i = 0; i < Length; ++i) {
+            if (!(i & 63)) c = deserializeBoolChunk(Data, Length - i);
+            Callback((bool)((c >> (i & 63)) & 1));
+        }
+    }
+    else {
+        for (size_t i = 0; i < Length; ++i) {
+            alignas(_T) uint8_t bytes[sizeof(_T)];
+            _T* p_v = (_T*)bytes;
+            Deserialize<_E>(Data, p_v);
+            _T v(std::move(*p_v));
+            p_v->~_T();
+            Callback(std::move(v));
+        }
+    }
+}
+
+template <bool _Bounded, typename _TRange>
+__forceinline size_t BSerializer::details::serializeBoolRange(void*& Data, const void* End, _TRange&& Range) {
+    size_t len = 0;
+    uint64_t m = 1;
+    uint64_t c = 0;
+    for (auto&& v : Range) {
+        if (!m) {
+            if constexpr (_Bounded) {
+                if ((size_t)((const uint8_t*)End - (uint8_t*)Data) < sizeof(uint64_t)) throwOutOfRange("The serialized range does not fit before parameter 'End'.");
+            }
+            BSerializer::Serialize(Data, c);
+            m = 1;
+            c = 0;
+        }
+        if ((bool)v) c |= m;
+        m <<= 1;
+        ++len;
+    }
+    if (len) {
+        if (m) {
+            size_t i = ((len & 63) + 7) >> 3;
+            if constexpr (_Bounded) {
+                if ((size_t)((const uint8_t*)End - (uint8_t*)Data) < i) throwOutOfRange("The serialized range does not fit before parameter 'End'.");
+            }
+            c = ToFromLittleEndian(c);
+            memcpy(Data, &c, i);
+            Data = ((uint8_t*)Data) + i;
+        }
+        else {
+            if constexpr (_Bounded) {
+                if ((size_t)((const uint8_t*)End - (uint8_t*)Data) < sizeof(uint64_t)) throwOutOfRange("The serialized range does not fit before parameter 'End'.");
+            }
+            BSerializer::Serialize(Data, c);
+        }
+    }
+    return len;
+}
+
+template <BSerializer::SerializableCollection _T, typename _TFunc>
+__forceinline void BSerializer::ForEachSerialized(const void*& Data, _TFunc&& Callback) {
+    ForEachSerialized<std::endian::little, _T>(Data, std::forward<_TFunc>(Callback));
+}
+
+template <BSerializer::SerializableCollection _T, typename _TFunc>
+__forceinline void BSerializer::ForEachSerialized(void*& Data, _TFunc&& Callback) {
+    ForEachSerialized<std::endian::little, _T>(Data, std::forward<_TFunc>(Callback));
+}
+
+template <BSerializer::Serializable _T, std::output_iterator<_T> _TIt>
+__forceinline _TIt BSerializer::DeserializeTo(const void*& Data, _TIt Out) {
+    return DeserializeTo<std::endian::little, _T>(Data, std::move(Out));
+}
+
+template <BSerializer::Serializable _T, std::output_iterator<_T> _TIt>
+__forceinline _TIt BSerializer::DeserializeTo(void*& Data, _TIt Out) {
+    return DeserializeTo<std::endian::little, _T>(Data, std::move(Out));
+}
+
+template <std::endian _E, BSerializer::SerializableCollection _T, typename _TFunc>
+__forceinline void BSerializer::ForEachSerialized(const void*& Data, _TFunc&& Callback) {
+    using value_t = typename _T::value_type;
+    size_t len = Deserialize<_E, size_t>(Data);
+    if constexpr (details::isMapEntryCallback<_T, _TFunc>::value) {
+        using key_t = typename _T::key_type;
+        using mapped_t = typename _T::mapped_type;
+        for (size_t i = 0; i < len; ++i) {
+            alignas(key_t) uint8_t keyBytes[sizeof(key_t)];
+            key_t* p_k = (key_t*)keyBytes;
+            Deserialize<_E>(Data, p_k);
+            key_t k(std::move(*p_k));
+            p_k->~key_t();
+            alignas(mapped_t) uint8_t mappedBytes[sizeof(mapped_t)];
+            mapped_t* p_m = (mapped_t*)mappedBytes;
+            Deserialize<_E>(Data, p_m);
+            mapped_t m(std::move(*p_m));
+            p_m->~mapped_t();
+            Callback(std::move(k), std::move(m));
+        }
+    }
+    else details::forEachSerializedElement<_E, value_t>(Data, len, Callback);
+}
+
+template <std::endian _E, BSerializer::SerializableCollection _T, typename _TFunc>
+__forceinline void BSerializer::ForEachSerialized(void*& Data, _TFunc&& Callback) {
+    ForEachSerialized<_E, _T>(const_cast<const void*&>(Data), std::forward<_TFunc>(Callback));
+}
+
+template <std::endian _E, BSerializer::Serializable _T, std::output_iterator<_T> _TIt>
+__forceinline _TIt BSerializer::DeserializeTo(const void*& Data, _TIt Out) {
+    size_t len = Deserialize<_E, size_t>(Data);
+    auto callback = [&Out](_T&& Value) {
+        *Out = std::move(Value);
+        ++Out;
+    };
+    details::forEachSerializedElement<_E, _T>(Data, len, callback);
+    return Out;
+}
+
+template <std::endian _E, BSerializer::Serializable _T, std::output_iterator<_T> _TIt>
+__forceinline _TIt BSerializer::DeserializeTo(void*& Data, _TIt Out) {
+    return DeserializeTo<_E, _T>(const_cast<const void*&>(Data), std::move(Out));
+}
+
+template <BSerializer::SerializableRange _TRange>
+    requires std::ranges::forward_range<_TRange> || (std::ranges::sized_range<_TRange> && BSerializer::Arithmetic<std::ranges::range_value_t<_TRange>>)
+__forceinline size_t BSerializer::SerializedRangeSize(_TRange&& Range) {
+    using value_t = std::ranges::range_value_t<_TRange>;
+    size_t t = sizeof(size_t);
+    if constexpr (std::same_as<value_t, bool>) {
+        size_t s = (size_t)std::ranges::distance(Range);
+        t += s >> 3;
+        if (s & 7) t += 1;
+    }
+    else if constexpr (Arithmetic<value_t> && std::ranges::sized_range<_TRange>) {
+        t += sizeof(value_t) * (size_t)std::ranges::size(Range);
+    }
+    else {
+        for (auto&& v : Range) {
+            const value_t& e = v;
+            t += SerializedSize(e);
+        }
+    }
+    return t;
+}
+
+template <BSerializer::SerializableRange _TRange>
+    requires std::ranges::forward_range<_TRange> || std::ranges::sized_range<_TRange>
+__forceinline void BSerializer::SerializeRange(void*& Data, _TRange&& Range) {
+    details::serializeRange<std::endian::little, false>(Data, 0, std::forward<_TRange>(Range));
+}
+
+template <std::endian _E, BSerializer::SerializableRange _TRange>
+    requires std::ranges::forward_range<_TRange> || std::ranges::sized_range<_TRange>
+__forceinline void BSerializer::SerializeRange(void*& Data, _TRange&& Range) {
+    details::serializeRange<_E, false>(Data, 0, std::forward<_TRange>(Range));
+}
+
+template <BSerializer::SerializableRange _TRange>
+__forceinline void BSerializer::SerializeRange(void*& Data, const void* End, _TRange&& Range) {
+    details::serializeRange<std::endian::little, true>(Data, End, std::forward<_TRange>(Range));
+}
+
+template <std::endian _E, BSerializer::SerializableRange _TRange>
+__forceinline void BSerializer::SerializeRange(void*& Data, const void* End, _TRange&& Range) {
+    details::serializeRange<_E, true>(Data, End, std::forward<_TRange>(Range));
+}
+
+template <std::endian _E, bool _Bounded, typename _TRange>
+__forceinline void BSerializer::details::serializeRange(void*& Data, const void* End, _TRange&& Range) {
+    using value_t = std::ranges::range_value_t<_TRange>;
+    void* p = Data;
+    auto reserve = [&p, End](size_t Size) {
+        if constexpr (_Bounded) {
+            if ((size_t)((const uint8_t*)End - (uint8_t*)p) < Size) throwOutOfRange("The serialized range does not fit before parameter 'End'.");
+        }
+    };
+    if constexpr (std::ranges::sized_range<_TRange>) {
+        size_t len = (size_t)std::ranges::size(Range);
+        reserve(sizeof(size_t));
+        Serialize<_E>(p, len);
+        if constexpr (std::same_as<value_t, bool>) {
+            serializeBoolRange<_Bounded>(p, End, Range);
+        }
+        else if constexpr (Arithmetic<value_t> && std::ranges::contiguous_range<_TRange> && _E == std::endian::native) {
+            reserve(sizeof(value_t) * len);
+            SerializeRaw(p, std::ranges::data(Range), sizeof(value_t) * len);
+        }
+        else {
+            if constexpr (Arithmetic<value_t>) reserve(sizeof(value_t) * len);
+            for (auto&& v : Range) {
+                const value_t& e = v;
+                if constexpr (!Arithmetic<value_t>) reserve(SerializedSize(e));
+                Serialize<_E>(p, e);
+            }
+        }
+    }
+    else {
+        reserve(sizeof(size_t));
+        void* lenData = p;
+        p = ((uint8_t*)p) + sizeof(size_t);
+        size_t len = 0;
+        if constexpr (std::same_as<value_t, bool>) {
+            len = serializeBoolRange<_Bounded>(p, End, Range);
+        }
+        else {
+            for (auto&& v : Range) {
+                const value_t& e = v;
+                if constexpr (Arithmetic<value_t>) reserve(sizeof(value_t));
+                else reserve(SerializedSize(e));
+                Serialize<_E>(p, e);
+                ++len;
+            }
+        }
+        Serialize<_E>(lenData, len);
+    }
+    Data = p;
 }
 
 template <typename _T>
@@ -761,7 +1511,7 @@ __forceinline void BSerializer::SerializeRaw(void*& Data, const void* Lower, con
 }
 
 __forceinline void BSerializer::SerializeRaw(void*& Data, const void* Lower, size_t Length) {
-    memcpy(Data, Lower, Length);
+    details::bulkCopy<false>(Data, Lower, Length);
     Data = ((uint8_t*)Data) + Length;
 }
 
@@ -770,6 +1520,98 @@ __forceinline void BSerializer::DeserializeRaw(const void*& Data, void* Lower, v
 }
 
 __forceinline void BSerializer::DeserializeRaw(const void*& Data, void* Lower, size_t Length) {
-    memcpy(Lower, Data, Length);
+    details::bulkCopy<true>(Lower, Data, Length);
     Data = ((uint8_t*)Data) + Length;
+}
+
+template <bool _PrefetchSource>
+inline void BSerializer::details::streamingCopy(void* Destination, const void* Source, size_t Size) {
+#ifdef BSERIALIZER_STREAMING_STORES
+#ifdef __AVX__
+    constexpr size_t width = sizeof(__m256i);
+#else
+    constexpr size_t width = sizeof(__m128i);
+#endif
+    uint8_t* d = (uint8_t*)Destination;
+    const uint8_t* s = (const uint8_t*)Source;
+    size_t head = (width - ((uintptr_t)d & (width - 1))) & (width - 1);
+    if (head > Size) head = Size;
+    memcpy(d, s, head);
+    d += head;
+    s += head;
+    Size -= head;
+    for (; Size >= width * 4; d += width * 4, s += width * 4, Size -= width * 4) {
+        if constexpr (_PrefetchSource) _mm_prefetch((const char*)s + 1024, _MM_HINT_NTA);
+#ifdef __AVX__
+        __m256i v0 = _mm256_loadu_si256((const __m256i*)s);
+        __m256i v1 = _mm256_loadu_si256((const __m256i*)(s + width));
+        __m256i v2 = _mm256_loadu_si256((const __m256i*)(s + width * 2));
+        __m256i v3 = _mm256_loadu_si256((const __m256i*)(s + width * 3));
+        _mm256_stream_si256((__m256i*)d, v0);
+        _mm256_stream_si256((__m256i*)(d + width), v1);
+        _mm256_stream_si256((__m256i*)(d + width * 2), v2);
+        _mm256_stream_si256((__m256i*)(d + width * 3), v3);
+#else
+        __m128i v0 = _mm_loadu_si128((const __m128i*)s);
+        __m128i v1 = _mm_loadu_si128((const __m128i*)(s + width));
+        __m128i v2 = _mm_loadu_si128((const __m128i*)(s + width * 2));
+        __m128i v3 = _mm_loadu_si128((const __m128i*)(s + width * 3));
+        _mm_stream_si128((__m128i*)d, v0);
+        _mm_stream_si128((__m128i*)(d + width), v1);
+        _mm_stream_si128((__m128i*)(d + width * 2), v2);
+        _mm_stream_si128((__m128i*)(d + width * 3), v3);
+#endif
+    }
+    _mm_sfence();
+    memcpy(d, s, Size);
+#else
+    memcpy(Destination, Source, Size);
+#endif
+}
+
+template <bool _PrefetchSource>
+__forceinline void BSerializer::details::bulkCopy(void* Destination, const void* Source, size_t Size) {
+    if (Size >= streamingThreshold.load(std::memory_order_relaxed)) [[unlikely]] streamingCopy<_PrefetchSource>(Destination, Source, Size);
+    else memcpy(Destination, Source, Size);
+}
+
+__forceinline void BSerializer::details::prefetch(const void* Address) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(Address, 0, 3);
+#elif defined(BSERIALIZER_STREAMING_STORES)
+    _mm_prefetch((const char*)Address, _MM_HINT_T0);
+#endif
+}
+
+template <typename _T>
+__forceinline void BSerializer::details::prefetchPayload(const _T& Value) {
+    if constexpr (SerializableStdPair<_T>) {
+        prefetchPayload(Value.first);
+        prefetchPayload(Value.second);
+    }
+    else if constexpr (hasPayload<_T>::value) {
+        if (Value.size()) prefetch(std::to_address(Value.cbegin()));
+    }
+}
+
+template <typename _T, typename _TFunc>
+__forceinline void BSerializer::details::forEachPrefetched(const _T& Value, _TFunc&& Func) {
+    if constexpr (prefetchedCollection<_T>) {
+        auto lower = std::to_address(Value.cbegin());
+        size_t len = Value.size();
+        for (size_t i = 0; i < prefetchDistance && i < len; ++i) prefetchPayload(lower[i]);
+        for (size_t i = 0; i < len; ++i) {
+            if (i + prefetchDistance < len) prefetchPayload(lower[i + prefetchDistance]);
+            Func(lower[i]);
+        }
+    }
+    else for (auto& v : Value) Func(v);
+}
+
+__forceinline void BSerializer::SetStreamingThreshold(size_t Threshold) {
+    details::streamingThreshold.store(Threshold, std::memory_order_relaxed);
+}
+
+__forceinline size_t BSerializer::StreamingThreshold() {
+    return details::streamingThreshold.load(std::memory_order_relaxed);
 }
\ No newline at end of file
@@ -0,0 +1,355 @@
+#pragma once
+
+#include <atomic>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+#include "Serializer.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace BSerializer {
+    namespace details {
+        constexpr size_t sharedRingLineSize = 64;
+        constexpr uint64_t sharedRingPadding = ~(uint64_t)0;
+
+        struct sharedRingHeader {
+            alignas(sharedRingLineSize) std::atomic<uint64_t> tail;
+            alignas(sharedRingLineSize) std::atomic<uint64_t> head;
+            alignas(sharedRingLineSize) uint64_t capacity;
+        };
+
+        static_assert(std::atomic<uint64_t>::is_always_lock_free, "BSerializer::SharedRing requires lock-free 64-bit atomics.");
+
+        __forceinline size_t sharedRingRecordSize(size_t Size);
+    }
+
+    /**
+     * @brief Returns the quantity of bytes of memory required for a shared ring of the given capacity.
+     * @param[in] Capacity The capacity of the ring's data area, in bytes. Capacity must be a power of two of at least 16.
+     * @return The quantity of bytes of memory required for the ring.
+     */
+    __forceinline size_t SharedRingSize(size_t Capacity);
+    /**
+     * @brief Initializes a shared ring in a region of memory. This must be done exactly once, by one process, before any producer or consumer attaches.
+     * @param[out] Memory A pointer to at least SharedRingSize(Capacity) bytes, aligned to 64 bytes.
+     * @param[in] Capacity The capacity of the ring's data area, in bytes. Capacity must be a power of two of at least 16.
+     */
+    __forceinline void InitializeSharedRing(void* Memory, size_t Capacity);
+
+    /**
+     * @brief A named region of memory shared between processes on the same host, created with `shm_open` on POSIX systems and `CreateFileMapping` on Windows.
+     */
+    class SharedMemory final {
+    public:
+        /**
+         * @brief Creates a named shared memory region, or opens it if it already exists, and maps it into the address space.
+         * @param[in] Name The name of the region. On POSIX systems, it should begin with '/'.
+         * @param[in] Size The size of the region, in bytes.
+         */
+        inline SharedMemory(const char* Name, size_t Size);
+        SharedMemory(const SharedMemory&) = delete;
+        SharedMemory& operator=(const SharedMemory&) = delete;
+        inline ~SharedMemory();
+
+        /**
+         * @brief Returns a pointer to the mapped region.
+         * @return A pointer to the mapped region.
+         */
+        __forceinline void* Data() const;
+        /**
+         * @brief Returns the size of the mapped region, in bytes.
+         * @return The size of the mapped region, in bytes.
+         */
+        __forceinline size_t Size() const;
+        /**
+         * @brief Removes the name of a shared memory region. Existing mappings remain valid. Does nothing on Windows, where the region is released with its last handle.
+         * @param[in] Name The name of the region.
+         */
+        static inline void Unlink(const char* Name);
+    private:
+        void* data;
+        size_t size;
+#ifdef _WIN32
+        HANDLE handle;
+#endif
+    };
+
+    /**
+     * @brief The producing end of a lock-free single-producer/single-consumer ring of serialized messages in shared memory.
+     *
+     * Messages are serialized directly into their slot in the ring and are never split across the wrap-around point. Head and tail indices live on separate cache lines, and each side caches the other's index so that it touches the shared line only when it appears to have run out of space or data.
+     * The tail index is published every PublishInterval messages, or on a call to Publish.
+     */
+    class SharedRingProducer final {
+    public:
+        /**
+         * @brief Attaches to an initialized shared ring as its only producer.
+         * @param[in] Memory A pointer to the memory of a ring initialized with BSerializer::InitializeSharedRing.
+         * @param[in] PublishInterval The quantity of committed messages after which the tail index is published automatically.
+         */
+        __forceinline SharedRingProducer(void* Memory, size_t PublishInterval = 1);
+
+        /**
+         * @brief Reserves a contiguous slot for a message in the ring.
+         * @param[in] Size The size of the message, in bytes. It must not exceed MaxMessageSize.
+         * @return A pointer to the slot, or null if the ring does not currently have room for the message.
+         * @exception std::length_error Thrown if the message is larger than MaxMessageSize, and so could never fit.
+         */
+        inline void* Reserve(size_t Size);
+        /**
+         * @brief Returns the size of the largest message the ring can hold, which is half its capacity less the 8-byte record header.
+         *
+         * Since messages are never split across the wrap-around point, a record larger than half the ring might fit neither after the current offset nor before it, and so could never be placed even in an empty ring. Half the ring always fits once the ring has drained.
+         * @return The size of the largest message the ring can hold, in bytes.
+         */
+        __forceinline size_t MaxMessageSize() const;
+        /**
+         * @brief Commits the message written into the slot returned by the last call to Reserve.
+         */
+        __forceinline void Commit();
+        /**
+         * @brief Makes all committed messages visible to the consumer.
+         */
+        __forceinline void Publish();
+        /**
+         * @brief Serializes a value directly into the ring and commits it. Since both ends of a ring share a host, the value is serialized in the architecture's byte order.
+         * @tparam _T The type of the value serialized. _T must conform to BSerializer::Serializable.
+         * @param[in] Value The value to serialize.
+         * @return Whether the ring had room for the value. If not, nothing is written.
+         * @exception std::length_error Thrown if the serialized value is larger than MaxMessageSize.
+         */
+        template <Serializable _T>
+        __forceinline bool Send(const _T& Value);
+    private:
+        details::sharedRingHeader* header;
+        uint8_t* data;
+        uint64_t mask;
+        uint64_t tail;
+        uint64_t cachedHead;
+        uint64_t reserved;
+        size_t publishInterval;
+        size_t unpublished;
+    };
+
+    /**
+     * @brief The consuming end of a lock-free single-producer/single-consumer ring of serialized messages in shared memory.
+     *
+     * Messages are read in place from the ring. The head index is published every PublishInterval messages, or on a call to Publish; space is returned to the producer only when the head index is published.
+     */
+    class SharedRingConsumer final {
+    public:
+        /**
+         * @brief Attaches to an initialized shared ring as its only consumer.
+         * @param[in] Memory A pointer to the memory of a ring initialized with BSerializer::InitializeSharedRing.
+         * @param[in] PublishInterval The quantity of released messages after which the head index is published automatically.
+         */
+        __forceinline SharedRingConsumer(void* Memory, size_t PublishInterval = 1);
+
+        /**
+         * @brief Returns the next message in the ring without consuming it.
+         * @param[out] Size The size of the message, in bytes.
+         * @return A pointer to the message, or null if the ring is empty.
+         */
+        inline const void* Peek(size_t& Size);
+        /**
+         * @brief Consumes the message returned by the last call to Peek. The message must not be accessed afterwards.
+         */
+        __forceinline void Release();
+        /**
+         * @brief Returns the space of all released messages to the producer.
+         */
+        __forceinline void Publish();
+        /**
+         * @brief Deserializes the next message in place and consumes it. The message must have been serialized in the architecture's byte order, as BSerializer::SharedRingProducer::Send does.
+         * @tparam _T The type of the value deserialized. _T must conform to BSerializer::Serializable.
+         * @param[out] Value A pointer to the location in memory in which the deserialized value will be placed.
+         * @return Whether a message was available. If not, nothing is written to Value.
+         */
+        template <Serializable _T>
+        __forceinline bool Receive(_T* Value);
+    private:
+        details::sharedRingHeader* header;
+        const uint8_t* data;
+        uint64_t mask;
+        uint64_t head;
+        uint64_t cachedTail;
+        uint64_t peeked;
+        size_t publishInterval;
+        size_t unpublished;
+    };
+}
+
+__forceinline size_t BSerializer::details::sharedRingRecordSize(size_t Size) {
+    return sizeof(uint64_t) + ((Size + 7) & ~(size_t)7);
+}
+
+__forceinline size_t BSerializer::SharedRingSize(size_t Capacity) {
+    return sizeof(details::sharedRingHeader) + Capacity;
+}
+
+__forceinline void BSerializer::InitializeSharedRing(void* Memory, size_t Capacity) {
+    if (Capacity < 16 || (Capacity & (Capacity - 1))) throw std::invalid_argument("Parameter 'Capacity' must be a power of two of at least 16.");
+    details::sharedRingHeader* header = new (Memory) details::sharedRingHeader;
+    header->capacity = Capacity;
+    header->head.store(0, std::memory_order_relaxed);
+    header->tail.store(0, std::memory_order_release);
+}
+
+#ifdef _WIN32
+inline BSerializer::SharedMemory::SharedMemory(const char* Name, size_t Size)
+    : size(Size) {
+    handle = CreateFileMappingA(INVALID_HANDLE_VALUE, 0, PAGE_READWRITE, (DWORD)((uint64_t)Size >> 32), (DWORD)Size, Name);
+    if (!handle) throw std::system_error((int)GetLastError(), std::system_category(), "CreateFileMapping");
+    data = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, Size);
+    if (!data) {
+        DWORD e = GetLastError();
+        CloseHandle(handle);
+        throw std::system_error((int)e, std::system_category(), "MapViewOfFile");
+    }
+}
+
+inline BSerializer::SharedMemory::~SharedMemory() {
+    UnmapViewOfFile(data);
+    CloseHandle(handle);
+}
+
+inline void BSerializer::SharedMemory::Unlink(const char* Name) { }
+#else
+inline BSerializer::SharedMemory::SharedMemory(const char* Name, size_t Size)
+    : size(Size) {
+    int fd = shm_open(Name, O_CREAT | O_RDWR, 0600);
+    if (fd < 0) throw std::system_error(errno, std::system_category(), "shm_open");
+    if (ftruncate(fd, (off_t)Size)) {
+        int e = errno;
+        close(fd);
+        throw std::system_error(e, std::system_category(), "ftruncate");
+    }
+    data = mmap(0, Size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    int e = errno;
+    close(fd);
+    if (data == MAP_FAILED) throw std::system_error(e, std::system_category(), "mmap");
+}
+
+inline BSerializer::SharedMemory::~SharedMemory() {
+    munmap(data, size);
+}
+
+inline void BSerializer::SharedMemory::Unlink(const char* Name) {
+    shm_unlink(Name);
+}
+#endif
+
+__forceinline void* BSerializer::SharedMemory::Data() const {
+    return data;
+}
+
+__forceinline size_t BSerializer::SharedMemory::Size() const {
+    return size;
+}
+
+__forceinline BSerializer::SharedRingProducer::SharedRingProducer(void* Memory, size_t PublishInterval)
+    : header((details::sharedRingHeader*)Memory), data((uint8_t*)Memory + sizeof(details::sharedRingHeader)), reserved(0), publishInterval(PublishInterval ? PublishInterval : 1), unpublished(0) {
+    mask = header->capacity - 1;
+    tail = header->tail.load(std::memory_order_relaxed);
+    cachedHead = header->head.load(std::memory_order_acquire);
+}
+
+inline void* BSerializer::SharedRingProducer::Reserve(size_t Size) {
+    if (Size > MaxMessageSize()) throw std::length_error("Parameter 'Size' exceeds the largest message the ring can hold.");
+    uint64_t record = details::sharedRingRecordSize(Size);
+    uint64_t capacity = mask + 1;
+    uint64_t offset = tail & mask;
+    uint64_t padding = offset + record > capacity ? capacity - offset : 0;
+    if (tail + padding + record - cachedHead > capacity) {
+        cachedHead = header->head.load(std::memory_order_acquire);
+        if (tail + padding + record - cachedHead > capacity) return 0;
+    }
+    if (padding) {
+        *(uint64_t*)(data + offset) = details::sharedRingPadding;
+        tail += padding;
+        offset = 0;
+    }
+    *(uint64_t*)(data + offset) = Size;
+    reserved = record;
+    return data + offset + sizeof(uint64_t);
+}
+
+__forceinline size_t BSerializer::SharedRingProducer::MaxMessageSize() const {
+    return (size_t)((mask + 1) >> 1) - sizeof(uint64_t);
+}
+
+__forceinline void BSerializer::SharedRingProducer::Commit() {
+    tail += reserved;
+    reserved = 0;
+    if (++unpublished >= publishInterval) Publish();
+}
+
+__forceinline void BSerializer::SharedRingProducer::Publish() {
+    header->tail.store(tail, std::memory_order_release);
+    unpublished = 0;
+}
+
+template <BSerializer::Serializable _T>
+__forceinline bool BSerializer::SharedRingProducer::Send(const _T& Value) {
+    void* p = Reserve(SerializedSize(Value));
+    if (!p) return false;
+    BSerializer::Serialize<std::endian::native>(p, Value);
+    Commit();
+    return true;
+}
+
+__forceinline BSerializer::SharedRingConsumer::SharedRingConsumer(void* Memory, size_t PublishInterval)
+    : header((details::sharedRingHeader*)Memory), data((const uint8_t*)Memory + sizeof(details::sharedRingHeader)), peeked(0), publishInterval(PublishInterval ? PublishInterval : 1), unpublished(0) {
+    mask = header->capacity - 1;
+    head = header->head.load(std::memory_order_relaxed);
+    cachedTail = header->tail.load(std::memory_order_acquire);
+}
+
+inline const void* BSerializer::SharedRingConsumer::Peek(size_t& Size) {
+    while (true) {
+        if (head == cachedTail) {
+            cachedTail = header->tail.load(std::memory_order_acquire);
+            if (head == cachedTail) return 0;
+        }
+        uint64_t offset = head & mask;
+        uint64_t s = *(const uint64_t*)(data + offset);
+        if (s == details::sharedRingPadding) {
+            head += mask + 1 - offset;
+            continue;
+        }
+        Size = (size_t)s;
+        peeked = details::sharedRingRecordSize(Size);
+        return data + offset + sizeof(uint64_t);
+    }
+}
+
+__forceinline void BSerializer::SharedRingConsumer::Release() {
+    head += peeked;
+    peeked = 0;
+    if (++unpublished >= publishInterval) Publish();
+}
+
+__forceinline void BSerializer::SharedRingConsumer::Publish() {
+    header->head.store(head, std::memory_order_release);
+    unpublished = 0;
+}
+
+template <BSerializer::Serializable _T>
+__forceinline bool BSerializer::SharedRingConsumer::Receive(_T* Value) {
+    size_t size;
+    const void* p = Peek(size);
+    if (!p) return false;
+    BSerializer::Deserialize<std::endian::native>(p, Value);
+    Release();
+    return true;
+}
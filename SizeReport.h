@@ -0,0 +1,320 @@
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Serializer.h"
+#include "TypeName.h"
+
+namespace BSerializer {
+    /**
+     * @brief A node of a BSerializer::SizeReport tree, describing the serialized bytes of a value and of its parts.
+     */
+    struct SizeReportNode final {
+        /**
+         * @brief The role of the value within its parent: "first" or "second" for pair members, "<i>" for tuple members and variant alternatives, "[]" for the elements of a collection or array, "value" for the content of an optional. Empty for the root.
+         */
+        std::string label;
+        /**
+         * @brief The name of the type of the value, as returned by BSerializer::TypeName.
+         */
+        std::string type;
+        /**
+         * @brief The quantity of values described by the node. Greater than one where elements of a collection, or values of a corpus, have been merged.
+         */
+        size_t instances;
+        /**
+         * @brief The serialized bytes of the values, including their children and overhead.
+         */
+        size_t bytes;
+        /**
+         * @brief The bytes spent on encoding overhead rather than content: length prefixes, variant indices, and optional flags.
+         */
+        size_t overhead;
+        /**
+         * @brief The parts of the values. The elements of a collection are merged into a single child, so the tree follows the shape of the type rather than of the data.
+         */
+        std::vector<SizeReportNode> children;
+    };
+
+    /**
+     * @brief The serialized bytes attributed to one type across a report.
+     */
+    struct SizeReportTypeTotal final {
+        /**
+         * @brief The name of the type, as returned by BSerializer::TypeName.
+         */
+        std::string type;
+        /**
+         * @brief The quantity of values of the type.
+         */
+        size_t instances;
+        /**
+         * @brief The serialized bytes of the values of the type, including nested values. Nested values of the same type are counted at every level.
+         */
+        size_t bytes;
+        /**
+         * @brief The encoding overhead of the values of the type itself, excluding that of nested values.
+         */
+        size_t overhead;
+    };
+
+    /**
+     * @brief Walks a value the same way BSerializer::SerializedSize does, and reports where its serialized bytes go.
+     * @tparam _T The type of the value. _T must conform to BSerializer::Serializable.
+     * @param[in] Value The value to report on.
+     * @return The root of the report. Its bytes equal BSerializer::SerializedSize(Value).
+     */
+    template <Serializable _T>
+    __forceinline SizeReportNode SizeReport(const _T& Value);
+
+    /**
+     * @brief Accumulates size reports over a corpus of values, merging the reports of values of the same type.
+     *
+     * Example:
+     * @code
+     * BSerializer::SizeReportCorpus corpus;
+     * for (const Message& m : sample) corpus.Add(m);
+     * std::cout << corpus.Dump();
+     * @endcode
+     */
+    class SizeReportCorpus final {
+    public:
+        /**
+         * @brief Adds the report of a value to the corpus.
+         * @tparam _T The type of the value. _T must conform to BSerializer::Serializable.
+         * @param[in] Value The value to report on.
+         */
+        template <Serializable _T>
+        __forceinline void Add(const _T& Value);
+        /**
+         * @brief Returns the merged report of each type of value added.
+         * @return One root per type of value added, in the order the types were first added.
+         */
+        __forceinline const std::vector<SizeReportNode>& Roots() const;
+        /**
+         * @brief Totals the reports by type, across every level of every root.
+         * @return One total per type, ordered by descending bytes.
+         */
+        inline std::vector<SizeReportTypeTotal> ByType() const;
+        /**
+         * @brief Formats the merged reports and the totals by type as text.
+         * @return The formatted reports.
+         */
+        inline std::string Dump() const;
+    private:
+        std::vector<SizeReportNode> roots;
+    };
+
+    /**
+     * @brief Totals a report by type, across every level.
+     * @param[in] Root The root of the report.
+     * @return One total per type, ordered by descending bytes.
+     */
+    inline std::vector<SizeReportTypeTotal> SizeReportByType(const SizeReportNode& Root);
+    /**
+     * @brief Formats a report as an indented tree, one node per line.
+     * @param[in] Root The root of the report.
+     * @return The formatted report.
+     */
+    inline std::string DumpSizeReport(const SizeReportNode& Root);
+
+    namespace details {
+        template <typename _T>
+        __forceinline void sizeReport(const _T& Value, SizeReportNode& Node);
+
+        template <typename _T>
+        __forceinline SizeReportNode& sizeReportChild(SizeReportNode& Node, std::string Label, const _T& Value);
+
+        inline void mergeSizeReport(SizeReportNode& Into, SizeReportNode&& From);
+
+        inline void totalSizeReport(const SizeReportNode& Node, std::vector<SizeReportTypeTotal>& Totals);
+
+        inline void dumpSizeReport(const SizeReportNode& Node, size_t Depth, std::string& Text);
+    }
+}
+
+template <typename _T>
+__forceinline void BSerializer::details::sizeReport(const _T& Value, SizeReportNode& Node) {
+    Node.type = TypeName<_T>();
+    Node.instances = 1;
+    Node.overhead = 0;
+    if constexpr (BuiltInSerializable<_T>) {
+        Node.bytes = Value.SerializedSize();
+    }
+    else if constexpr (SerializableCollection<_T>) {
+        using value_t = typename _T::value_type;
+        Node.overhead = sizeof(size_t);
+        Node.bytes = SerializedSize(Value);
+        if constexpr (!std::same_as<value_t, bool>) {
+            if (Value.size()) {
+                SizeReportNode elements;
+                elements.label = "[]";
+                elements.type = TypeName<value_t>();
+                elements.instances = 0;
+                elements.bytes = 0;
+                elements.overhead = 0;
+                if constexpr (Arithmetic<value_t>) {
+                    elements.instances = Value.size();
+                    elements.bytes = sizeof(value_t) * Value.size();
+                }
+                else {
+                    for (auto& v : Value) {
+                        SizeReportNode e;
+                        sizeReport(v, e);
+                        e.label = "[]";
+                        mergeSizeReport(elements, std::move(e));
+                    }
+                }
+                Node.children.push_back(std::move(elements));
+            }
+        }
+    }
+    else if constexpr (SerializableStdPair<_T>) {
+        Node.bytes =
+            sizeReportChild(Node, "first", Value.first).bytes +
+            sizeReportChild(Node, "second", Value.second).bytes;
+    }
+    else if constexpr (SerializableStdTuple<_T>) {
+        Node.bytes = 0;
+        [&]<size_t... _Indices>(std::index_sequence<_Indices...>) {
+            ((Node.bytes += sizeReportChild(Node, "<" + std::to_string(_Indices) + ">", std::get<_Indices>(Value)).bytes), ...);
+        }(std::make_index_sequence<std::tuple_size_v<_T>>());
+    }
+    else if constexpr (SerializableStdArray<_T>) {
+        Node.bytes = SerializedSize(Value);
+        if constexpr (std::tuple_size_v<_T> != 0) {
+            SizeReportNode elements;
+            elements.instances = 0;
+            elements.bytes = 0;
+            elements.overhead = 0;
+            for (auto& v : Value) {
+                SizeReportNode e;
+                sizeReport(v, e);
+                mergeSizeReport(elements, std::move(e));
+            }
+            elements.label = "[]";
+            Node.children.push_back(std::move(elements));
+        }
+    }
+    else if constexpr (SerializableStdOptional<_T>) {
+        Node.overhead = sizeof(bool);
+        Node.bytes = sizeof(bool);
+        if (Value) Node.bytes += sizeReportChild(Node, "value", *Value).bytes;
+    }
+    else if constexpr (SerializableStdVariant<_T>) {
+        Node.overhead = sizeof(size_t);
+        Node.bytes = sizeof(size_t);
+        std::visit([&](const auto& Alternative) {
+            using alternative_t = std::remove_cvref_t<decltype(Alternative)>;
+            if constexpr (!std::same_as<alternative_t, std::monostate>) Node.bytes += sizeReportChild(Node, "<" + std::to_string(Value.index()) + ">", Alternative).bytes;
+        }, Value);
+    }
+    else {
+        Node.bytes = SerializedSize(Value);
+    }
+}
+
+template <typename _T>
+__forceinline BSerializer::SizeReportNode& BSerializer::details::sizeReportChild(SizeReportNode& Node, std::string Label, const _T& Value) {
+    SizeReportNode& c = Node.children.emplace_back();
+    sizeReport(Value, c);
+    c.label = std::move(Label);
+    return c;
+}
+
+inline void BSerializer::details::mergeSizeReport(SizeReportNode& Into, SizeReportNode&& From) {
+    if (Into.type.empty()) Into.type = std::move(From.type);
+    Into.instances += From.instances;
+    Into.bytes += From.bytes;
+    Into.overhead += From.overhead;
+    for (SizeReportNode& c : From.children) {
+        auto it = std::find_if(Into.children.begin(), Into.children.end(), [&c](const SizeReportNode& N) {
+            return N.label == c.label && N.type == c.type;
+        });
+        if (it == Into.children.end()) Into.children.push_back(std::move(c));
+        else mergeSizeReport(*it, std::move(c));
+    }
+}
+
+inline void BSerializer::details::totalSizeReport(const SizeReportNode& Node, std::vector<SizeReportTypeTotal>& Totals) {
+    auto it = std::find_if(Totals.begin(), Totals.end(), [&Node](const SizeReportTypeTotal& T) {
+        return T.type == Node.type;
+    });
+    if (it == Totals.end()) Totals.push_back({ Node.type, Node.instances, Node.bytes, Node.overhead });
+    else {
+        it->instances += Node.instances;
+        it->bytes += Node.bytes;
+        it->overhead += Node.overhead;
+    }
+    for (const SizeReportNode& c : Node.children) totalSizeReport(c, Totals);
+}
+
+inline void BSerializer::details::dumpSizeReport(const SizeReportNode& Node, size_t Depth, std::string& Text) {
+    Text.append(Depth * 2, ' ');
+    if (!Node.label.empty()) {
+        Text += Node.label;
+        Text += ' ';
+    }
+    Text += Node.type;
+    Text += ": " + std::to_string(Node.bytes) + " bytes";
+    if (Node.overhead) Text += ", " + std::to_string(Node.overhead) + " overhead";
+    if (Node.instances != 1) Text += ", " + std::to_string(Node.instances) + " instances";
+    Text += '\n';
+    for (const SizeReportNode& c : Node.children) dumpSizeReport(c, Depth + 1, Text);
+}
+
+template <BSerializer::Serializable _T>
+__forceinline BSerializer::SizeReportNode BSerializer::SizeReport(const _T& Value) {
+    SizeReportNode n;
+    details::sizeReport(Value, n);
+    return n;
+}
+
+template <BSerializer::Serializable _T>
+__forceinline void BSerializer::SizeReportCorpus::Add(const _T& Value) {
+    SizeReportNode n = SizeReport(Value);
+    auto it = std::find_if(roots.begin(), roots.end(), [&n](const SizeReportNode& R) {
+        return R.type == n.type;
+    });
+    if (it == roots.end()) roots.push_back(std::move(n));
+    else details::mergeSizeReport(*it, std::move(n));
+}
+
+__forceinline const std::vector<BSerializer::SizeReportNode>& BSerializer::SizeReportCorpus::Roots() const {
+    return roots;
+}
+
+inline std::vector<BSerializer::SizeReportTypeTotal> BSerializer::SizeReportCorpus::ByType() const {
+    std::vector<SizeReportTypeTotal> totals;
+    for (const SizeReportNode& r : roots) details::totalSizeReport(r, totals);
+    std::sort(totals.begin(), totals.end(), [](const SizeReportTypeTotal& A, const SizeReportTypeTotal& B) {
+        return A.bytes > B.bytes;
+    });
+    return totals;
+}
+
+inline std::string BSerializer::SizeReportCorpus::Dump() const {
+    std::string s;
+    for (const SizeReportNode& r : roots) details::dumpSizeReport(r, 0, s);
+    for (const SizeReportTypeTotal& t : ByType()) {
+        s += t.type + ": " + std::to_string(t.instances) + " instances, " + std::to_string(t.bytes) + " bytes, " + std::to_string(t.overhead) + " overhead\n";
+    }
+    return s;
+}
+
+inline std::vector<BSerializer::SizeReportTypeTotal> BSerializer::SizeReportByType(const SizeReportNode& Root) {
+    std::vector<SizeReportTypeTotal> totals;
+    details::totalSizeReport(Root, totals);
+    std::sort(totals.begin(), totals.end(), [](const SizeReportTypeTotal& A, const SizeReportTypeTotal& B) {
+        return A.bytes > B.bytes;
+    });
+    return totals;
+}
+
+inline std::string BSerializer::DumpSizeReport(const SizeReportNode& Root) {
+    std::string s;
+    details::dumpSizeReport(Root, 0, s);
+    return s;
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "Serializer.h"
+
+namespace BSerializer {
+    /**
+     * @brief The measurements of one copy size in BSerializer::BenchmarkStreamingThreshold.
+     */
+    struct StreamingBenchmarkResult final {
+        /**
+         * @brief The size of each copy, in bytes.
+         */
+        size_t bytes;
+        /**
+         * @brief The throughput of copies through the cache, with memcpy, in bytes per second.
+         */
+        double cachedBytesPerSecond;
+        /**
+         * @brief The throughput of copies with non-temporal stores, as BSerializer makes above the streaming threshold, in bytes per second.
+         */
+        double streamingBytesPerSecond;
+        /**
+         * @brief The mean time to read the working set back after a copy through the cache, in nanoseconds.
+         */
+        double cachedReloadNanoseconds;
+        /**
+         * @brief The mean time to read the working set back after a copy with non-temporal stores, in nanoseconds.
+         */
+        double streamingReloadNanoseconds;
+    };
+
+    /**
+     * @brief Times raw copies of increasing sizes through the cache and with non-temporal stores, so that the streaming threshold can be chosen for the machine at hand.
+     *
+     * Before each copy, a working set standing in for the rest of the application is read into the cache; after it, the working set is read again, so that the eviction caused by the copy shows as a longer reload. Sizes run from MinSize up to MaxSize, doubling each time.
+     * Without BSERIALIZER_STREAMING_STORES, both kinds of copy are memcpy.
+     *
+     * Example:
+     * @code
+     * BSerializer::SetStreamingThreshold(BSerializer::SuggestStreamingThreshold(BSerializer::BenchmarkStreamingThreshold()));
+     * @endcode
+     * @param[in] WorkingSet The size of the working set, in bytes.
+     * @param[in] MinSize The smallest copy size, in bytes.
+     * @param[in] MaxSize The largest copy size, in bytes.
+     * @param[in] Iterations The quantity of timed copies per size and kind.
+     * @return One result per copy size.
+     */
+    inline std::vector<StreamingBenchmarkResult> BenchmarkStreamingThreshold(size_t WorkingSet = 1 << 20, size_t MinSize = 64 << 10, size_t MaxSize = 64 << 20, size_t Iterations = 8);
+    /**
+     * @brief Returns the measured size that, used as the streaming threshold, minimizes the cost per byte summed over all measured sizes, counting both the copy and the reload of the working set. Summing over sizes keeps a single noisy measurement from deciding the result.
+     * @param[in] Results The results of BSerializer::BenchmarkStreamingThreshold.
+     * @return The suggested streaming threshold, in bytes, or SIZE_MAX if non-temporal stores never paid off.
+     */
+    inline size_t SuggestStreamingThreshold(const std::vector<StreamingBenchmarkResult>& Results);
+
+    namespace details {
+        inline uint64_t touchWorkingSet(const uint8_t* WorkingSet, size_t Size);
+    }
+}
+
+inline uint64_t BSerializer::details::touchWorkingSet(const uint8_t* WorkingSet, size_t Size) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < Size; i += 64) sum += *(const volatile uint8_t*)(WorkingSet + i);
+    return sum;
+}
+
+inline std::vector<BSerializer::StreamingBenchmarkResult> BSerializer::BenchmarkStreamingThreshold(size_t WorkingSet, size_t MinSize, size_t MaxSize, size_t Iterations) {
+    if (!MinSize) MinSize = 1;
+    if (MaxSize < MinSize) MaxSize = MinSize;
+    if (!Iterations) Iterations = 1;
+    std::unique_ptr<uint8_t[]> source(new uint8_t[MaxSize]);
+    std::unique_ptr<uint8_t[]> destination(new uint8_t[MaxSize]);
+    std::unique_ptr<uint8_t[]> working(new uint8_t[WorkingSet ? WorkingSet : 1]);
+    memset(source.get(), 1, MaxSize);
+    memset(destination.get(), 0, MaxSize);
+    memset(working.get(), 2, WorkingSet);
+    std::vector<StreamingBenchmarkResult> results;
+    for (size_t n = MinSize;; n = n * 2 < MaxSize ? n * 2 : MaxSize) {
+        std::chrono::steady_clock::duration copy[2] = { };
+        std::chrono::steady_clock::duration reload[2] = { };
+        for (size_t i = 0; i < Iterations; ++i) {
+            for (size_t k = 0; k < 2; ++k) {
+                details::touchWorkingSet(working.get(), WorkingSet);
+                auto t0 = std::chrono::steady_clock::now();
+                if (k) details::streamingCopy<true>(destination.get(), source.get(), n);
+                else memcpy(destination.get(), source.get(), n);
+                auto t1 = std::chrono::steady_clock::now();
+                details::touchWorkingSet(working.get(), WorkingSet);
+                auto t2 = std::chrono::steady_clock::now();
+                copy[k] += t1 - t0;
+                reload[k] += t2 - t1;
+            }
+        }
+        double bytes = (double)n * Iterations;
+        results.push_back({
+            n,
+            bytes / std::chrono::duration<double>(copy[0]).count(),
+            bytes / std::chrono::duration<double>(copy[1]).count(),
+            std::chrono::duration<double, std::nano>(reload[0]).count() / Iterations,
+            std::chrono::duration<double, std::nano>(reload[1]).count() / Iterations
+        });
+        if (n == MaxSize) break;
+    }
+    return results;
+}
+
+inline size_t BSerializer::SuggestStreamingThreshold(const std::vector<StreamingBenchmarkResult>& Results) {
+    double cost = 0;
+    for (const StreamingBenchmarkResult& r : Results) cost += (r.bytes / r.cachedBytesPerSecond * 1e9 + r.cachedReloadNanoseconds) / r.bytes;
+    double best = cost;
+    size_t threshold = SIZE_MAX;
+    for (size_t i = Results.size(); i--; ) {
+        const StreamingBenchmarkResult& r = Results[i];
+        cost -= (r.bytes / r.cachedBytesPerSecond * 1e9 + r.cachedReloadNanoseconds) / r.bytes;
+        cost += (r.bytes / r.streamingBytesPerSecond * 1e9 + r.streamingReloadNanoseconds) / r.bytes;
+        if (cost < best) {
+            best = cost;
+            threshold = r.bytes;
+        }
+    }
+    return threshold;
+}
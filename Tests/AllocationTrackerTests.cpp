@@ -0,0 +1,49 @@
+#define BSERIALIZER_DEFINE_ALLOCATION_HOOKS
+#include <stdexcept>
+#include <vector>
+#include "Check.h"
+#include "AllocationTracker.h"
+#include "Serializer.h"
+
+int main() {
+    CHECK(BSerializer::AllocationHooksInstalled());
+
+    std::vector<int> ints(1000, 7);
+    std::vector<uint8_t> buffer(BSerializer::SerializedSize(ints));
+    void* q = buffer.data();
+    BSerializer::Serialize(q, ints);
+
+    BSerializer::BufferPool::Local().Trim();
+    const void* p = buffer.data();
+    std::vector<int> value;
+    BSerializer::AllocationCounts cold = BSerializer::CountAllocations([&] { value = BSerializer::Deserialize<std::vector<int>>(p); });
+    CHECK(cold.allocations == 2);
+    CHECK(value == ints);
+
+    p = buffer.data();
+    BSerializer::ExpectAllocations(1, [&] { value = BSerializer::Deserialize<std::vector<int>>(p); });
+    CHECK(value == ints);
+
+    bool threw = false;
+    try {
+        BSerializer::ExpectAllocations(0, [] { delete new int(1); });
+    }
+    catch (const std::logic_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    {
+        BSerializer::AllocationScope outer;
+        std::vector<char> a(100);
+        {
+            BSerializer::AllocationScope inner;
+            std::vector<char> b(50);
+            BSerializer::AllocationCounts c = inner.Counts();
+            CHECK(c.allocations == 1 && c.bytes == 50 && c.peakBytes == 50);
+        }
+        BSerializer::AllocationCounts c = outer.Counts();
+        CHECK(c.allocations == 2 && c.deallocations == 1 && c.bytes == 150 && c.peakBytes == 150);
+    }
+    return 0;
+}
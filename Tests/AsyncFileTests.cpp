@@ -0,0 +1,79 @@
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <sys/stat.h>
+#include <vector>
+#include "AsyncFile.h"
+#include "Check.h"
+
+using Message = std::pair<uint32_t, std::vector<uint16_t>>;
+
+static void RoundTrip(int File, bool Direct, BSerializer::HugePages Pages) {
+    const int count = 3000;
+    CHECK(!ftruncate(File, 0));
+    {
+        BSerializer::AsyncFileWriter w(File, 8192, 3, 0, Direct, Pages);
+        for (int i = 0; i < count; ++i) {
+            w.Serialize(Message((uint32_t)i, std::vector<uint16_t>((i * 7) % 5000, (uint16_t)i)));
+            if (i % 997 == 0) w.Flush();
+        }
+        w.Write("TAIL", 4);
+        w.Flush();
+        struct stat st;
+        CHECK(!fstat(File, &st));
+        CHECK((off_t)w.Offset() == st.st_size);
+    }
+    for (size_t chunk : { 4096, 8192 * 4 }) {
+        BSerializer::AsyncFileReader r(File, chunk, 3, 0, Direct);
+        alignas(Message) uint8_t storage[sizeof(Message)];
+        for (int i = 0; i < count; ++i) {
+            CHECK(r.Deserialize((Message*)storage));
+            Message& m = *(Message*)storage;
+            CHECK((int)m.first == i);
+            CHECK(m.second.size() == (size_t)((i * 7) % 5000));
+            CHECK(m.second.empty() || m.second.back() == (uint16_t)i);
+            m.~Message();
+        }
+        char tail[8];
+        CHECK(r.Read(tail, 8) == 4 && !memcmp(tail, "TAIL", 4));
+        CHECK(r.Read(tail, 8) == 0);
+    }
+    CHECK(!(fcntl(File, F_GETFL) & O_DIRECT));
+}
+
+int main() {
+    {
+        BSerializer::PageBuffer b(10, BSerializer::HugePages::Transparent);
+        CHECK(b.Capacity() == BSerializer::details::hugePageSize && ((uintptr_t)b.Data() & 4095) == 0);
+        memset(b.Data(), 1, b.Capacity());
+    }
+    {
+        BSerializer::PageBuffer b(10, BSerializer::HugePages::Explicit);
+        CHECK(b.Data());
+        memset(b.Data(), 1, b.Capacity());
+    }
+    std::string pattern = (std::filesystem::temp_directory_path() / "bserializer_file_XXXXXX").string();
+    int file = mkstemp(pattern.data());
+    CHECK(file >= 0);
+    unlink(pattern.c_str());
+    RoundTrip(file, false, BSerializer::HugePages::None);
+    bool direct = true;
+    try {
+        BSerializer::AsyncFileWriter probe(file, 8192, 1, 0, true);
+    }
+    catch (const std::system_error&) {
+        direct = false;
+    }
+    if (direct) RoundTrip(file, true, BSerializer::HugePages::Transparent);
+    std::vector<Message> values;
+    for (int i = 0; i < 200; ++i) values.emplace_back((uint32_t)i, std::vector<uint16_t>(i * 13, (uint16_t)i));
+    auto results = BSerializer::BenchmarkAsyncFile(file, values, 8192, 3);
+    CHECK(results.size() == 6);
+    for (const BSerializer::AsyncFileBenchmarkResult& r : results) {
+        CHECK(r.supported == (!r.direct || direct));
+        if (!r.supported) continue;
+        CHECK(r.bytes >= 200 * sizeof(uint64_t) && r.writeBytesPerSecond > 0 && r.readBytesPerSecond > 0);
+    }
+    close(file);
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+#include "BufferPool.h"
+#include "Check.h"
+#include "Serializer.h"
+
+using Alternatives = std::variant<int, std::string>;
+
+template <typename _T>
+static bool ThrowsOnBadIndex(_T Value, size_t IndexOffset) {
+    std::vector<uint8_t> buffer(BSerializer::SerializedSize(Value));
+    void* p = buffer.data();
+    BSerializer::Serialize(p, Value);
+    size_t bad = 7;
+    memcpy(buffer.data() + IndexOffset, &bad, sizeof(size_t));
+    const void* q = buffer.data();
+    try {
+        BSerializer::Deserialize<_T>(q);
+    }
+    catch (const std::out_of_range&) {
+        return true;
+    }
+    return false;
+}
+
+int main() {
+    BSerializer::BufferPool& pool = BSerializer::BufferPool::Local();
+    pool.Trim();
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 8; ++i) blocks.push_back(pool.Acquire(1000));
+    std::thread([&] {
+        BSerializer::BufferPool& consumer = BSerializer::BufferPool::Local();
+        for (void* b : blocks) consumer.Release(b);
+        CHECK(consumer.Statistics().retained == 0);
+    }).join();
+    CHECK(pool.Statistics().retained == 0);
+    size_t hits = pool.Statistics().hits;
+    void* b = pool.Acquire(1000);
+    CHECK(pool.Statistics().hits == hits + 1);
+    CHECK(pool.Statistics().retained == 7 * BSerializer::BufferPool::Capacity(b));
+    pool.Release(b);
+
+    {
+        BSerializer::PooledBuffer buffer(100);
+        std::thread([&] { BSerializer::PooledBuffer moved(std::move(buffer)); }).join();
+    }
+    pool.Trim();
+    CHECK(pool.Statistics().retained == 0);
+
+    void* orphan = 0;
+    std::thread([&] { orphan = BSerializer::BufferPool::Local().Acquire(64); }).join();
+    size_t discards = pool.Statistics().discards;
+    pool.Release(orphan);
+    CHECK(pool.Statistics().discards == discards + 1);
+    CHECK(pool.Statistics().retained == 0);
+
+    std::vector<Alternatives> elements{ 1, std::string("x") };
+    std::pair<std::array<int, 100>, Alternatives> pair{ { }, 2 };
+    CHECK(ThrowsOnBadIndex(elements, 2 * sizeof(size_t) + sizeof(int)));
+    CHECK(ThrowsOnBadIndex(pair, sizeof(pair.first)));
+    size_t retained = pool.Statistics().retained;
+    CHECK(retained != 0);
+    hits = pool.Statistics().hits;
+    CHECK(ThrowsOnBadIndex(elements, 2 * sizeof(size_t) + sizeof(int)));
+    CHECK(ThrowsOnBadIndex(pair, sizeof(pair.first)));
+    CHECK(pool.Statistics().hits == hits + 2);
+    CHECK(pool.Statistics().retained == retained);
+
+    void* large = pool.Acquire((size_t)1 << 27);
+    std::thread([&] { BSerializer::BufferPool::Local().Release(large); }).join();
+    return 0;
+}
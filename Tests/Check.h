@@ -0,0 +1,6 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+#define CHECK(Condition) ((Condition) ? (void)0 : (std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #Condition), std::exit(1)))
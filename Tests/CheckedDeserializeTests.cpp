@@ -0,0 +1,103 @@
+#define BSERIALIZER_DEFINE_ALLOCATION_HOOKS
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+#include "AllocationTracker.h"
+#include "Check.h"
+#include "CheckedDeserialize.h"
+
+template <typename _T>
+static std::vector<uint8_t> Serialized(const _T& Value) {
+    std::vector<uint8_t> buffer(BSerializer::SerializedSize(Value));
+    void* p = buffer.data();
+    BSerializer::Serialize(p, Value);
+    return buffer;
+}
+
+template <typename _T>
+static BSerializer::DeserializeError Try(const std::vector<uint8_t>& Buffer, size_t Size, _T& Out) {
+    alignas(_T) uint8_t storage[sizeof(_T)];
+    const void* p = Buffer.data();
+    BSerializer::DeserializeError e = BSerializer::TryDeserialize(p, Buffer.data() + Size, (_T*)storage);
+    if (e == BSerializer::DeserializeError::None) {
+        CHECK(p == Buffer.data() + Size);
+        Out = std::move(*(_T*)storage);
+        ((_T*)storage)->~_T();
+    }
+    else CHECK(p == Buffer.data());
+    return e;
+}
+
+int main() {
+    using Book = std::map<std::string, std::vector<std::pair<double, std::optional<std::string>>>>;
+    Book book;
+    for (int i = 0; i < 30; ++i) book["k" + std::to_string(i)] = { { i * 0.5, i % 2 ? std::optional<std::string>("v") : std::nullopt } };
+    std::vector<uint8_t> buffer = Serialized(book);
+    Book back;
+    CHECK(Try(buffer, buffer.size(), back) == BSerializer::DeserializeError::None && back == book);
+    for (size_t n = 0; n < buffer.size(); ++n) {
+        BSerializer::DeserializeError e = Try(buffer, n, back);
+        CHECK(e == BSerializer::DeserializeError::Truncated || e == BSerializer::DeserializeError::OversizedLength);
+    }
+
+    std::vector<uint8_t> oversized = Serialized(std::vector<int>{ 1, 2, 3 });
+    size_t huge = (size_t)1 << 60;
+    memcpy(oversized.data(), &huge, sizeof(huge));
+    std::vector<int> ints;
+    CHECK(Try(oversized, oversized.size(), ints) == BSerializer::DeserializeError::OversizedLength);
+
+    std::variant<int, float> variant = 1.5f;
+    std::vector<uint8_t> badIndex = Serialized(variant);
+    size_t index = 7;
+    memcpy(badIndex.data(), &index, sizeof(index));
+    CHECK(Try(badIndex, badIndex.size(), variant) == BSerializer::DeserializeError::BadTag);
+
+    std::optional<int> optional = 4;
+    std::vector<uint8_t> badFlag = Serialized(optional);
+    badFlag[0] = 2;
+    CHECK(Try(badFlag, badFlag.size(), optional) == BSerializer::DeserializeError::BadTag);
+
+    {
+        BSerializer::DeserializationContext context(buffer.data() + buffer.size(), 64);
+        CHECK(Try(buffer, buffer.size(), back) == BSerializer::DeserializeError::OverBudget);
+        CHECK(context.Used() == 0);
+    }
+    {
+        BSerializer::DeserializationContext context(oversized.data() + oversized.size(), (size_t)-1);
+        const void* p = oversized.data();
+        bool threw = false;
+        try {
+            BSerializer::Deserialize<std::vector<int>>(p);
+        }
+        catch (const std::length_error&) {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+
+    using Nested = std::vector<std::vector<std::string>>;
+    Nested nested(3, Nested::value_type(4, std::string(40, 'n')));
+    std::vector<uint8_t> corrupt = Serialized(nested);
+    memcpy(corrupt.data() + sizeof(size_t) + 2 * BSerializer::SerializedSize(nested[0]), &huge, sizeof(huge));
+    BSerializer::BufferPool::Local().Trim();
+    {
+        BSerializer::AllocationScope scope;
+        {
+            BSerializer::DeserializationContext context(corrupt.data() + corrupt.size(), (size_t)-1);
+            const void* p = corrupt.data();
+            bool threw = false;
+            try {
+                BSerializer::Deserialize<Nested>(p);
+            }
+            catch (const std::length_error&) {
+                threw = true;
+            }
+            CHECK(threw);
+        }
+        BSerializer::BufferPool::Local().Trim();
+        BSerializer::AllocationCounts counts = scope.Counts();
+        CHECK(counts.allocations > 0 && counts.allocations == counts.deallocations);
+    }
+    return 0;
+}
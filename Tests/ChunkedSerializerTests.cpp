@@ -0,0 +1,60 @@
+#define BSERIALIZER_DEFINE_ALLOCATION_HOOKS
+#include <map>
+#include <string>
+#include <vector>
+#include "AllocationTracker.h"
+#include "Check.h"
+#include "ChunkedSerializer.h"
+
+template <std::endian _E, typename _T>
+static void SerializeInChunks(const _T& Value, std::vector<uint8_t>& Chunk, std::vector<uint8_t>& Out) {
+    BSerializer::ChunkedSerializer serializer(Value, BSerializer::EndianTag<_E>());
+    BSerializer::ChunkResult result;
+    do {
+        void* p = Chunk.data();
+        result = serializer.Serialize(p, Chunk.size());
+        Out.insert(Out.end(), Chunk.data(), (uint8_t*)p);
+    } while (result == BSerializer::ChunkResult::NeedsMoreSpace);
+    CHECK(serializer.IsComplete());
+}
+
+template <std::endian _E, typename _T>
+static std::vector<uint8_t> Chunked(const _T& Value, size_t ChunkSize) {
+    std::vector<uint8_t> out;
+    std::vector<uint8_t> chunk(ChunkSize);
+    SerializeInChunks<_E>(Value, chunk, out);
+    return out;
+}
+
+template <std::endian _E, typename _T>
+static void CheckChunked(const _T& Value) {
+    std::vector<uint8_t> expected(BSerializer::SerializedSize(Value));
+    void* p = expected.data();
+    BSerializer::Serialize<_E>(p, Value);
+    for (size_t size : { 1, 3, 7, 64, 255, 257, 1000, 1 << 16 }) CHECK(Chunked<_E>(Value, size) == expected);
+}
+
+int main() {
+    std::map<std::string, std::vector<std::pair<int16_t, std::string>>> book;
+    for (int i = 0; i < 50; ++i) {
+        auto& entries = book["key" + std::to_string(i)];
+        for (int j = 0; j < i; ++j) entries.emplace_back(j, std::string(j * 13, 'a' + j % 26));
+    }
+    CheckChunked<std::endian::little>(book);
+    CheckChunked<std::endian::big>(book);
+    CheckChunked<std::endian::little>(std::array<std::optional<std::string>, 3>{ std::string(300, 'x'), std::nullopt, std::string("y") });
+
+    CHECK(BSerializer::AllocationHooksInstalled());
+    std::vector<std::pair<int32_t, std::string>> small(10000, { 7, "element" });
+    std::vector<std::pair<int32_t, std::string>> large(100000, { 7, "element" });
+    std::vector<uint8_t> chunk(4096);
+    std::vector<uint8_t> bytes;
+    bytes.reserve(BSerializer::SerializedSize(large));
+    BSerializer::AllocationCounts c = BSerializer::CountAllocations([&] { SerializeInChunks<std::endian::little>(small, chunk, bytes); });
+    CHECK(c.allocations && c.allocations < 8 && c.allocations == c.deallocations);
+    CHECK(bytes.size() == BSerializer::SerializedSize(small));
+    bytes.clear();
+    BSerializer::ExpectAllocations(c.allocations, [&] { SerializeInChunks<std::endian::little>(large, chunk, bytes); });
+    CHECK(bytes.size() == BSerializer::SerializedSize(large));
+    return 0;
+}
@@ -0,0 +1,40 @@
+#include <chrono>
+#include <cstdio>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Runs a compiler command and reports its wall time, CPU time and peak memory.
+// Usage: CompileBenchmark <label> <compiler> <arguments...>
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::fprintf(stderr, "usage: %s <label> <compiler> <arguments...>\n", argv[0]);
+        return 2;
+    }
+    auto t0 = std::chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid < 0) {
+        std::perror("fork");
+        return 1;
+    }
+    if (!pid) {
+        execvp(argv[2], argv + 2);
+        std::perror("execvp");
+        _exit(127);
+    }
+    int status;
+    rusage usage;
+    if (wait4(pid, &status, 0, &usage) != pid) {
+        std::perror("wait4");
+        return 1;
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    if (!WIFEXITED(status) || WEXITSTATUS(status)) {
+        std::fprintf(stderr, "%s: compilation failed\n", argv[1]);
+        return 1;
+    }
+    double cpu = usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+    std::printf("%s: %.2f s wall, %.2f s CPU, %ld MB peak\n", argv[1], std::chrono::duration<double>(t1 - t0).count(), cpu, usage.ru_maxrss / 1024);
+    return 0;
+}
@@ -0,0 +1,46 @@
+#include <array>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <variant>
+#include <vector>
+#include "Check.h"
+#include "Serializer.h"
+
+// A translation unit that stresses the variant, tuple and trait machinery at compile time. The CompileBenchmark target times its compilation.
+
+template <size_t... _Is>
+std::variant<std::monostate, std::array<int, _Is + 1>...> WideVariant(std::index_sequence<_Is...>);
+template <size_t... _Is>
+std::tuple<std::pair<int, std::array<short, _Is + 1>>...> LongTuple(std::index_sequence<_Is...>);
+
+using Wide = decltype(WideVariant(std::make_index_sequence<40>()));
+using Long = decltype(LongTuple(std::make_index_sequence<30>()));
+template <size_t _N>
+using Deep = std::tuple<Wide, Long, std::vector<Wide>, std::optional<Long>, std::array<int, _N>>;
+
+template <size_t _N>
+static void RoundTrip() {
+    Deep<_N> value{};
+    std::get<0>(value).template emplace<_N * 4>();
+    std::get<0>(std::get<1>(value)).first = (int)_N;
+    std::get<2>(value) = { Wide(), Wide(std::in_place_index<_N>), Wide(std::in_place_index<40>) };
+    std::get<3>(value) = std::get<1>(value);
+    std::get<4>(value).fill((int)_N);
+    std::vector<uint8_t> buffer(BSerializer::SerializedSize(value));
+    void* p = buffer.data();
+    BSerializer::Serialize(p, value);
+    CHECK(p == buffer.data() + buffer.size());
+    const void* q = buffer.data();
+    CHECK(BSerializer::Deserialize<Deep<_N>>(q) == value);
+}
+
+template <size_t... _Ns>
+static void RoundTrips(std::index_sequence<_Ns...>) {
+    (RoundTrip<_Ns + 1>(), ...);
+}
+
+int main() {
+    RoundTrips(std::make_index_sequence<8>());
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include <array>
+#include <cstring>
+#include <map>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <variant>
+#include <vector>
+#include "Check.h"
+#include "GatherSerializer.h"
+
+using Record = std::tuple<int, std::vector<double>, std::string, std::vector<int>, std::array<float, 512>, std::optional<std::vector<uint16_t>>, std::variant<int, std::vector<int64_t>>, std::map<int, std::vector<double>>>;
+
+static std::vector<uint8_t> Concatenate(const BSerializer::GatherSerializer& Gather) {
+    std::vector<uint8_t> bytes;
+    for (size_t i = 0; i < Gather.SegmentCount(); ++i) {
+        const uint8_t* p = (const uint8_t*)Gather.Segments()[i].iov_base;
+        bytes.insert(bytes.end(), p, p + Gather.Segments()[i].iov_len);
+    }
+    CHECK(bytes.size() == Gather.Size());
+    return bytes;
+}
+
+template <std::endian _E, typename _T>
+static std::vector<uint8_t> Contiguous(const _T& Value) {
+    std::vector<uint8_t> buffer(BSerializer::SerializedSize(Value));
+    void* p = buffer.data();
+    BSerializer::Serialize<_E>(p, Value);
+    return buffer;
+}
+
+static bool References(const BSerializer::GatherSerializer& Gather, const void* Data, size_t Size) {
+    for (size_t i = 0; i < Gather.SegmentCount(); ++i) {
+        if (Gather.Segments()[i].iov_base == Data && Gather.Segments()[i].iov_len == Size) return true;
+    }
+    return false;
+}
+
+int main() {
+    Record record;
+    std::get<0>(record) = 7;
+    std::get<1>(record).assign(1000, 1.5);
+    std::get<2>(record) = "gather";
+    std::get<3>(record) = { 1, 2, 3 };
+    std::get<4>(record).fill(0.25f);
+    std::get<5>(record) = std::vector<uint16_t>(2000, 9);
+    std::get<6>(record) = std::vector<int64_t>(128, -1);
+    std::get<7>(record) = { { 1, std::vector<double>(200, 2.0) }, { 2, { 3.0 } } };
+
+    BSerializer::GatherSerializer gather(1024, 64);
+    gather.Serialize<std::endian::native>(record);
+    CHECK(Concatenate(gather) == Contiguous<std::endian::native>(record));
+    CHECK(References(gather, std::get<1>(record).data(), 1000 * sizeof(double)));
+    CHECK(References(gather, std::get<4>(record).data(), 512 * sizeof(float)));
+    CHECK(References(gather, std::get<5>(record)->data(), 2000 * sizeof(uint16_t)));
+    CHECK(References(gather, std::get<std::vector<int64_t>>(std::get<6>(record)).data(), 128 * sizeof(int64_t)));
+    CHECK(References(gather, std::get<7>(record)[1].data(), 200 * sizeof(double)));
+    CHECK(!References(gather, std::get<3>(record).data(), 3 * sizeof(int)));
+    CHECK(!References(gather, std::get<7>(record)[2].data(), sizeof(double)));
+
+    std::vector<uint8_t> threshold(1024, 5);
+    std::vector<uint8_t> below(1023, 6);
+    gather.Clear();
+    CHECK(gather.SegmentCount() == 0 && gather.Size() == 0);
+    gather.Serialize<std::endian::native>(threshold);
+    gather.Serialize<std::endian::native>(below);
+    CHECK(References(gather, threshold.data(), threshold.size()));
+    CHECK(!References(gather, below.data(), below.size()));
+    std::vector<uint8_t> expected = Contiguous<std::endian::native>(threshold);
+    std::vector<uint8_t> tail = Contiguous<std::endian::native>(below);
+    expected.insert(expected.end(), tail.begin(), tail.end());
+    CHECK(Concatenate(gather) == expected);
+
+    constexpr std::endian foreign = std::endian::native == std::endian::little ? std::endian::big : std::endian::little;
+    BSerializer::GatherSerializer swapped;
+    swapped.Serialize<foreign>(record);
+    CHECK(Concatenate(swapped) == Contiguous<foreign>(record));
+    CHECK(!References(swapped, std::get<1>(record).data(), 1000 * sizeof(double)));
+
+    BSerializer::GatherSerializer raw;
+    const char text[] = "referenced";
+    raw.SerializeRaw("copied", 6);
+    raw.SerializeRawReference(text, sizeof(text) - 1);
+    raw.Serialize(std::string("tail"));
+    CHECK(References(raw, text, sizeof(text) - 1));
+    std::vector<uint8_t> bytes = Concatenate(raw);
+    CHECK(!memcmp(bytes.data(), "copiedreferenced", 16));
+    CHECK(bytes.size() == 16 + BSerializer::SerializedSize(std::string("tail")));
+    return 0;
+}
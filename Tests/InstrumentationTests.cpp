@@ -0,0 +1,68 @@
+#define BSERIALIZER_INSTRUMENT
+#include <string>
+#include <thread>
+#include <vector>
+#include "Check.h"
+#include "Serializer.h"
+
+static const BSerializer::InstrumentationEntry* Find(const std::vector<BSerializer::InstrumentationEntry>& Entries, const char* Type, BSerializer::InstrumentedOperation Operation) {
+    for (const BSerializer::InstrumentationEntry& e : Entries) {
+        if (e.type == Type && e.operation == Operation) return &e;
+    }
+    return 0;
+}
+
+static uint64_t HistogramTotal(const BSerializer::InstrumentationEntry& Entry) {
+    uint64_t t = 0;
+    for (uint64_t h : Entry.histogram) t += h;
+    return t;
+}
+
+int main() {
+    using Values = std::vector<std::string>;
+    const char* name = BSerializer::TypeName<Values>();
+    Values values(20, std::string(30, 'i'));
+    size_t size = BSerializer::SerializedSize(values);
+    std::vector<uint8_t> buffer(size);
+
+    BSerializer::ResetInstrumentation();
+    CHECK(BSerializer::InstrumentationSnapshot().empty());
+    CHECK(BSerializer::DumpInstrumentationJson() == "[]");
+    for (int i = 0; i < 10; ++i) {
+        void* p = buffer.data();
+        BSerializer::Serialize(p, values);
+    }
+    for (int i = 0; i < 7; ++i) {
+        const void* q = buffer.data();
+        CHECK(BSerializer::Deserialize<Values>(q) == values);
+    }
+    std::thread([&values] {
+        for (int i = 0; i < 5; ++i) CHECK(BSerializer::SerializedSize(values));
+    }).join();
+
+    std::vector<BSerializer::InstrumentationEntry> entries = BSerializer::InstrumentationSnapshot();
+    CHECK(entries.size() == 3);
+    const BSerializer::InstrumentationEntry* serialize = Find(entries, name, BSerializer::InstrumentedOperation::Serialize);
+    const BSerializer::InstrumentationEntry* deserialize = Find(entries, name, BSerializer::InstrumentedOperation::Deserialize);
+    const BSerializer::InstrumentationEntry* sized = Find(entries, name, BSerializer::InstrumentedOperation::SerializedSize);
+    CHECK(serialize && serialize->calls == 10 && serialize->bytes == 10 * size && HistogramTotal(*serialize) == 10);
+    CHECK(deserialize && deserialize->calls == 7 && deserialize->bytes == 7 * size && HistogramTotal(*deserialize) == 7);
+    CHECK(sized && sized->calls == 5 && sized->bytes == 0 && HistogramTotal(*sized) == 5);
+    CHECK(!Find(entries, BSerializer::TypeName<std::string>(), BSerializer::InstrumentedOperation::Serialize));
+    for (size_t i = 1; i < entries.size(); ++i) CHECK(entries[i - 1].cycles >= entries[i].cycles);
+
+    std::string text = BSerializer::DumpInstrumentation(entries);
+    CHECK(text.find("Serialize " + std::string(name) + ": calls=10 bytes=" + std::to_string(10 * size) + " ") != std::string::npos);
+    std::string json = BSerializer::DumpInstrumentationJson(entries);
+    CHECK(json.front() == '[' && json.back() == ']');
+    CHECK(json.find("{\"type\":\"" + std::string(name) + "\",\"operation\":\"Deserialize\",\"calls\":7,\"bytes\":" + std::to_string(7 * size) + ",\"cycles\":") != std::string::npos);
+    CHECK(json.find("\"operation\":\"SerializedSize\",\"calls\":5,\"bytes\":0,") != std::string::npos);
+
+    BSerializer::InstrumentationEntry quoted = *serialize;
+    quoted.type = "a\"b\\c";
+    CHECK(BSerializer::DumpInstrumentationJson({ quoted }).starts_with("[{\"type\":\"a\\\"b\\\\c\","));
+
+    BSerializer::ResetInstrumentation();
+    CHECK(BSerializer::InstrumentationSnapshot().empty());
+    return 0;
+}
@@ -0,0 +1,29 @@
+#include <map>
+#include <string>
+#include <vector>
+#include "Check.h"
+#include "CheckedDeserialize.h"
+
+int main() {
+    using Book = std::map<std::string, std::vector<std::pair<double, std::optional<std::string>>>>;
+    Book book;
+    for (int i = 0; i < 30; ++i) book["k" + std::to_string(i)] = { { i * 0.5, i % 2 ? std::optional<std::string>("v") : std::nullopt } };
+    std::vector<uint8_t> buffer(BSerializer::SerializedSize(book));
+    void* p = buffer.data();
+    BSerializer::Serialize(p, book);
+    size_t size;
+    CHECK(BSerializer::Validate<Book>(buffer.data(), buffer.data() + buffer.size(), size) == BSerializer::DeserializeError::None && size == buffer.size());
+    BSerializer::DeserializeError e = BSerializer::Validate<Book>(buffer.data(), buffer.data() + buffer.size() - 1, size);
+    CHECK(e == BSerializer::DeserializeError::Truncated || e == BSerializer::DeserializeError::OversizedLength);
+    alignas(Book) uint8_t storage[sizeof(Book)];
+    const void* q = buffer.data();
+    CHECK(BSerializer::TryDeserialize(q, buffer.data() + buffer.size(), (Book*)storage) == BSerializer::DeserializeError::None);
+    CHECK(*(Book*)storage == book);
+    ((Book*)storage)->~Book();
+    {
+        BSerializer::DeserializationContext context(buffer.data() + buffer.size(), 64);
+        q = buffer.data();
+        CHECK(BSerializer::TryDeserialize(q, buffer.data() + buffer.size(), (Book*)storage) == BSerializer::DeserializeError::OverBudget);
+    }
+    return 0;
+}
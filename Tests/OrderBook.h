@@ -0,0 +1,25 @@
+#pragma once
+
+#include <map>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <variant>
+#include <vector>
+
+using Order = std::tuple<uint64_t, std::string, std::optional<std::vector<int32_t>>, std::variant<std::monostate, int, std::string>>;
+using Book = std::map<std::string, std::vector<Order>>;
+
+inline Book MakeBook(int Keys, int OrdersPerKey) {
+    Book book;
+    for (int i = 0; i < Keys; ++i) {
+        std::vector<Order>& orders = book["k" + std::to_string(i)];
+        for (int j = 0; j < OrdersPerKey; ++j) {
+            std::variant<std::monostate, int, std::string> tag;
+            if (j % 3 == 1) tag = j;
+            else if (j % 3 == 2) tag = std::string("tag");
+            orders.emplace_back(i * j, "sym" + std::to_string(j), j % 2 ? std::optional<std::vector<int32_t>>({ 1, 2, j }) : std::nullopt, tag);
+        }
+    }
+    return book;
+}
@@ -0,0 +1,37 @@
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#ifdef OUT_OF_LINE_BENCHMARK
+#include "OutOfLineTypes.h"
+#else
+#include "OrderBook.h"
+#include "Serializer.h"
+#endif
+
+// Times a hot round-trip loop and a hot SerializedSize loop over an order book. It is built once in the default mode and once out of line with extern instantiations; the OutOfLineBenchmarkRun target runs both and prints the code size of each build.
+
+int main() {
+#ifdef OUT_OF_LINE_BENCHMARK
+    const char* mode = "out of line";
+#else
+    const char* mode = "default";
+#endif
+    const int iterations = 200;
+    Book book = MakeBook(1000, 16);
+    std::vector<uint8_t> buffer(BSerializer::SerializedSize(book));
+    size_t check = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        void* p = buffer.data();
+        BSerializer::Serialize(p, book);
+        const void* q = buffer.data();
+        check += BSerializer::Deserialize<Book>(q).size();
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) check += BSerializer::SerializedSize(book);
+    auto t2 = std::chrono::steady_clock::now();
+    std::printf("%s: round trip %.2f ms, SerializedSize %.3f ms (%zu)\n", mode,
+        std::chrono::duration<double, std::milli>(t1 - t0).count() / iterations,
+        std::chrono::duration<double, std::milli>(t2 - t1).count() / iterations, check);
+    return 0;
+}
@@ -0,0 +1,4 @@
+#include "OutOfLineTypes.h"
+
+BSERIALIZER_INSTANTIATE(Order)
+BSERIALIZER_INSTANTIATE(Book)
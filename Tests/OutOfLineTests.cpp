@@ -0,0 +1,13 @@
+#include "Check.h"
+#include "OutOfLineTypes.h"
+
+int main() {
+    Book book = MakeBook(20, 4);
+    std::vector<uint8_t> buffer(BSerializer::SerializedSize(book));
+    void* p = buffer.data();
+    BSerializer::Serialize(p, book);
+    CHECK(p == buffer.data() + buffer.size());
+    const void* q = buffer.data();
+    CHECK(BSerializer::Deserialize<Book>(q) == book);
+    return 0;
+}
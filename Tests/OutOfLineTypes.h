@@ -0,0 +1,8 @@
+#pragma once
+
+#define BSERIALIZER_OUT_OF_LINE
+#include "OrderBook.h"
+#include "Serializer.h"
+
+BSERIALIZER_EXTERN(Order)
+BSERIALIZER_EXTERN(Book)
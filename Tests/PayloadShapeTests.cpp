@@ -0,0 +1,79 @@
+#include <cmath>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <variant>
+#include <vector>
+#include "Check.h"
+#include "PayloadShape.h"
+
+using Message = std::tuple<std::vector<std::string>, std::optional<int>, std::variant<std::monostate, int, std::vector<double>>, std::vector<std::pair<int, std::optional<std::string>>>>;
+
+static Message MakeMessage(size_t I) {
+    Message m;
+    for (size_t j = 0; j < I % 5; ++j) std::get<0>(m).push_back(std::string((I * 7 + j) % 40, 's'));
+    if (I % 4) std::get<1>(m) = (int)I;
+    if (I % 4 == 1) std::get<2>(m) = (int)I;
+    else if (I % 4 != 0) std::get<2>(m) = std::vector<double>(I % 9, 0.5);
+    for (size_t j = 0; j < I % 3; ++j) std::get<3>(m).emplace_back((int)j, j ? std::optional<std::string>("x") : std::nullopt);
+    return m;
+}
+
+static uint64_t Sum(const std::vector<uint64_t>& Counts) {
+    uint64_t t = 0;
+    for (uint64_t c : Counts) t += c;
+    return t;
+}
+
+// Checks that two distributions have the same support and proportions within Tolerance.
+static void CheckDistribution(const std::vector<uint64_t>& Expected, const std::vector<uint64_t>& Actual, double Tolerance) {
+    CHECK(Expected.size() == Actual.size());
+    uint64_t e = Sum(Expected);
+    uint64_t a = Sum(Actual);
+    for (size_t i = 0; i < Expected.size(); ++i) {
+        CHECK(!Expected[i] == !Actual[i]);
+        if (e && a) CHECK(std::abs((double)Expected[i] / e - (double)Actual[i] / a) < Tolerance);
+    }
+}
+
+int main() {
+    BSerializer::PayloadShape recorded;
+    for (size_t i = 0; i < 2000; ++i) recorded.Record(MakeMessage(i));
+    CHECK(recorded.Nodes().count("/<1>"));
+    CHECK(recorded.Nodes().at("/<1>").present == 1500 && recorded.Nodes().at("/<1>").absent == 500);
+    CHECK((recorded.Nodes().at("/<2>").alternatives == std::vector<uint64_t>{ 500, 500, 1000 }));
+    CHECK(recorded.Nodes().at("/<0>").lengths[0] == 400);
+    CHECK(recorded.Nodes().count("/<3>/[]/second"));
+
+    std::vector<uint8_t> buffer(BSerializer::SerializedSize(recorded));
+    void* p = buffer.data();
+    BSerializer::Serialize(p, recorded);
+    CHECK(p == buffer.data() + buffer.size());
+    const void* q = buffer.data();
+    BSerializer::PayloadShape shipped = BSerializer::Deserialize<BSerializer::PayloadShape>(q);
+    CHECK(q == buffer.data() + buffer.size());
+    CHECK(shipped.Nodes().size() == recorded.Nodes().size());
+    for (auto& [path, n] : recorded.Nodes()) {
+        const BSerializer::PayloadShapeNode& s = shipped.Nodes().at(path);
+        CHECK(s.lengths == n.lengths && s.alternatives == n.alternatives && s.present == n.present && s.absent == n.absent);
+    }
+
+    CHECK(shipped.Generate<Message>(5) == shipped.Generate<Message>(5));
+    BSerializer::PayloadShape regenerated;
+    for (uint64_t seed = 0; seed < 20000; ++seed) regenerated.Record(shipped.Generate<Message>(seed));
+    CHECK(regenerated.Nodes().size() == recorded.Nodes().size());
+    for (auto& [path, n] : recorded.Nodes()) {
+        const BSerializer::PayloadShapeNode& g = regenerated.Nodes().at(path);
+        CheckDistribution(n.lengths, g.lengths, 0.02);
+        CheckDistribution(n.alternatives, g.alternatives, 0.02);
+        CheckDistribution({ n.present, n.absent }, { g.present, g.absent }, 0.02);
+    }
+
+    BSerializer::PayloadShape empty;
+    CHECK(empty.Generate<Message>(1) == Message());
+
+    BSerializer::ShapeBenchmarkResult r = BSerializer::BenchmarkShape<Message>(shipped, 100, 0, 1);
+    CHECK(r.values == 100 && r.bytes > 100 * sizeof(size_t));
+    return 0;
+}
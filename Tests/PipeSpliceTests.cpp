@@ -0,0 +1,41 @@
+#include <filesystem>
+#include <thread>
+#include <vector>
+#include "Check.h"
+#include "PipeSplice.h"
+
+int main() {
+    std::vector<uint32_t> values(300000);
+    for (size_t i = 0; i < values.size(); ++i) values[i] = (uint32_t)(i * 2654435761u);
+    size_t size = BSerializer::SerializedSize(values);
+    std::string pattern = (std::filesystem::temp_directory_path() / "bserializer_splice_XXXXXX").string();
+    for (bool splicing : { true, false }) {
+        int p[2];
+        CHECK(!pipe(p));
+        int file = mkstemp(pattern.data());
+        CHECK(file >= 0);
+        unlink(pattern.c_str());
+        std::thread writer([&] {
+            BSerializer::PipeSink sink(p[1], splicing);
+            sink.Send(values);
+            sink.Send(values);
+            close(p[1]);
+        });
+        BSerializer::PipeSource source(p[0], splicing);
+        size_t moved = source.Transfer(file, size * 3);
+        writer.join();
+        CHECK(moved == 2 * size);
+        std::vector<uint8_t> back(moved);
+        CHECK(pread(file, back.data(), moved, 0) == (ssize_t)moved);
+        const void* q = back.data() + size;
+        CHECK(BSerializer::Deserialize<std::vector<uint32_t>>(q) == values);
+        close(p[0]);
+        close(file);
+        pattern.replace(pattern.size() - 6, 6, "XXXXXX");
+    }
+
+    BSerializer::PipeBenchmarkResult r = BSerializer::BenchmarkPipeSplice(values, 8);
+    CHECK(r.bytes == size * 8);
+    CHECK(r.copyBytesPerSecond > 0 && r.spliceBytesPerSecond > 0);
+    return 0;
+}
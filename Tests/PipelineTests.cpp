@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Check.h"
+#include "Pipeline.h"
+
+using Record = std::pair<uint32_t, std::string>;
+
+static std::vector<Record> MakeRecords() {
+    std::vector<Record> records;
+    for (uint32_t i = 0; i < 300; ++i) records.emplace_back(i, std::string((i * 37) % 1000, (char)('a' + i % 26)));
+    return records;
+}
+
+static std::vector<uint8_t> Expected(const std::vector<Record>& Records) {
+    std::vector<uint8_t> bytes;
+    for (const Record& r : Records) {
+        uint64_t size = BSerializer::SerializedSize(r);
+        size_t offset = bytes.size();
+        bytes.resize(offset + sizeof(uint64_t) + size);
+        void* p = bytes.data() + offset;
+        BSerializer::Serialize(p, size);
+        BSerializer::Serialize(p, r);
+    }
+    return bytes;
+}
+
+// Reads from memory in chunks of varying size, so that records span buffers at different offsets. The input ends at the end of Bytes, and fails after Limit bytes if Limit is less than that.
+static std::function<size_t(void*, size_t)> MemorySource(const std::vector<uint8_t>& Bytes, size_t Limit) {
+    size_t offset = 0;
+    size_t call = 0;
+    return [&Bytes, Limit, offset, call](void* Data, size_t Size) mutable {
+        if (offset == Limit && Limit < Bytes.size()) throw std::runtime_error("The source failed.");
+        size_t s = std::min({ Size, Limit - offset, 1 + (call++ * 53) % 97 });
+        memcpy(Data, Bytes.data() + offset, s);
+        offset += s;
+        return s;
+    };
+}
+
+int main() {
+    std::vector<Record> records = MakeRecords();
+    std::vector<uint8_t> expected = Expected(records);
+
+    for (size_t depth : { 1, 3 }) {
+        std::vector<uint8_t> sink;
+        {
+            BSerializer::PipelinedWriter writer([&sink](const void* Data, size_t Size) { sink.insert(sink.end(), (const uint8_t*)Data, (const uint8_t*)Data + Size); }, 256, depth);
+            for (const Record& r : records) writer.Serialize(r);
+            writer.Flush();
+        }
+        CHECK(sink == expected);
+
+        BSerializer::PipelinedReader reader(MemorySource(sink, sink.size()), 256, depth);
+        for (const Record& r : records) {
+            alignas(Record) uint8_t storage[sizeof(Record)];
+            CHECK(reader.Deserialize((Record*)storage));
+            CHECK(*(Record*)storage == r);
+            ((Record*)storage)->~Record();
+        }
+        alignas(Record) uint8_t storage[sizeof(Record)];
+        CHECK(!reader.Deserialize((Record*)storage));
+    }
+
+    {
+        size_t calls = 0;
+        BSerializer::PipelinedWriter writer([&calls](const void*, size_t) {
+            ++calls;
+            throw std::runtime_error("The sink failed.");
+        }, 1 << 16, 2);
+        writer.Serialize(records[1]);
+        writer.Serialize(records[2]);
+        bool threw = false;
+        try {
+            writer.Flush();
+        }
+        catch (const std::runtime_error&) {
+            threw = true;
+        }
+        CHECK(threw);
+        CHECK(calls == 1);
+        writer.Serialize(records[3]);
+        writer.Flush();
+        CHECK(calls == 1);
+    }
+
+    {
+        size_t boundary = 0;
+        size_t intact = 120;
+        for (size_t i = 0; i < intact; ++i) boundary += sizeof(uint64_t) + BSerializer::SerializedSize(records[i]);
+        BSerializer::PipelinedReader reader(MemorySource(expected, boundary), 256, 3);
+        size_t read = 0;
+        bool threw = false;
+        try {
+            while (true) {
+                alignas(Record) uint8_t storage[sizeof(Record)];
+                if (!reader.Deserialize((Record*)storage)) break;
+                CHECK(*(Record*)storage == records[read]);
+                ((Record*)storage)->~Record();
+                ++read;
+            }
+        }
+        catch (const std::runtime_error&) {
+            threw = true;
+        }
+        CHECK(threw);
+        CHECK(read == intact);
+    }
+    return 0;
+}
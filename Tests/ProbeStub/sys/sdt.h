@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstdint>
+
+// Stands in for SystemTap's <sys/sdt.h> in ProbesTests: each probe calls RecordProbe, defined by the test, instead of emitting a note.
+
+void RecordProbe(const char* Name, uint64_t A, uint64_t B);
+
+#define STAP_PROBE2(Provider, Name, A, B) RecordProbe(#Name, (uint64_t)(A), (uint64_t)(B))
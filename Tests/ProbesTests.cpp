@@ -0,0 +1,57 @@
+#define BSERIALIZER_PROBES
+#include <string>
+#include <vector>
+#include "Check.h"
+#include "Serializer.h"
+
+// Built with Tests/ProbeStub ahead of the system headers, so the probes record into this list rather than requiring SystemTap.
+
+struct Probe {
+    std::string name;
+    uint64_t a;
+    uint64_t b;
+
+    bool operator==(const Probe&) const = default;
+};
+
+static std::vector<Probe> probes;
+
+void RecordProbe(const char* Name, uint64_t A, uint64_t B) {
+    probes.push_back(Probe{ Name, A, B });
+}
+
+int main() {
+    using Inner = std::vector<int>;
+    using Outer = std::vector<Inner>;
+    Outer value{ { 1, 2 }, { 3 }, { } };
+    std::vector<uint8_t> buffer(BSerializer::SerializedSize(value));
+    uint64_t hash = BSerializer::TypeHash<Outer>();
+    uint64_t name = (uint64_t)BSerializer::TypeName<Outer>();
+    uint64_t innerHash = BSerializer::TypeHash<Inner>();
+    uint64_t intHash = BSerializer::TypeHash<int>();
+
+    void* p = buffer.data();
+    BSerializer::Serialize(p, value);
+    CHECK((probes == std::vector<Probe>{ { "serialize__start", hash, name }, { "serialize__end", hash, buffer.size() } }));
+
+    probes.clear();
+    const void* q = buffer.data();
+    CHECK(BSerializer::Deserialize<Outer>(q) == value);
+    std::vector<Probe> expected{ { "deserialize__start", hash, name }, { "collection__decode__start", hash, 3 }, { "alloc", innerHash, 3 * sizeof(Inner) } };
+    for (const Inner& i : value) {
+        expected.push_back({ "collection__decode__start", innerHash, i.size() });
+        expected.push_back({ "alloc", intHash, i.size() * sizeof(int) });
+        expected.push_back({ "collection__decode__end", innerHash, i.size() });
+    }
+    expected.push_back({ "collection__decode__end", hash, 3 });
+    expected.push_back({ "deserialize__end", hash, buffer.size() });
+    CHECK(probes == expected);
+
+    probes.clear();
+    p = buffer.data();
+    BSerializer::Serialize(p, 42);
+    q = buffer.data();
+    CHECK(BSerializer::Deserialize<int>(q) == 42);
+    CHECK(probes.empty());
+    return 0;
+}
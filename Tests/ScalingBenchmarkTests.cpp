@@ -0,0 +1,13 @@
+#include <string>
+#include <vector>
+#include "Check.h"
+#include "ScalingBenchmark.h"
+
+int main() {
+    std::vector<std::pair<int, std::string>> values(100, { 1, std::string(64, 'x') });
+    std::vector<BSerializer::ScalingBenchmarkResult> results = BSerializer::BenchmarkScaling(values, 3, 2);
+    CHECK(results.size() == 3);
+    CHECK(results[0].threads == 1 && results[1].threads == 2 && results[2].threads == 3);
+    for (const BSerializer::ScalingBenchmarkResult& r : results) CHECK(r.serializePerThread > 0 && r.deserializePerThread > 0);
+    return 0;
+}
@@ -0,0 +1,24 @@
+#include <string>
+#include <vector>
+#include "Check.h"
+#include "SerializedElements.h"
+
+int main() {
+    std::vector<std::string> values;
+    for (int i = 0; i < 20; ++i) values.push_back(std::string(i, 'a' + i));
+    std::vector<uint8_t> buffer(BSerializer::SerializedSize(values));
+    void* p = buffer.data();
+    BSerializer::Serialize(p, values);
+
+    auto elements = BSerializer::Elements<std::vector<std::string>>(buffer.data());
+    CHECK(elements.size() == values.size());
+    for (int pass = 0; pass < 2; ++pass) {
+        size_t i = 0;
+        for (const std::string& s : elements) CHECK(s == values[i++]);
+        CHECK(i == values.size());
+    }
+    size_t taken = 0;
+    for (const std::string& s : elements | std::views::take(3)) CHECK(s == values[taken++]);
+    CHECK(taken == 3);
+    return 0;
+}
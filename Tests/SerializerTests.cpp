@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <iterator>
+#include <list>
+#include <map>
+#include <ranges>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Check.h"
+#include "Serializer.h"
+
+template <std::endian _E = std::endian::little, typename _T>
+static void RoundTrip(const _T& Value) {
+    std::vector<uint8_t> buffer(BSerializer::SerializedSize(Value));
+    void* p = buffer.data();
+    BSerializer::Serialize<_E>(p, Value);
+    CHECK(p == buffer.data() + buffer.size());
+    const void* q = buffer.data();
+    CHECK((BSerializer::Deserialize<_E, _T>(q) == Value));
+    CHECK(q == buffer.data() + buffer.size());
+}
+
+template <typename _T>
+static std::vector<uint8_t> SerializeToBuffer(const _T& Value) {
+    std::vector<uint8_t> buffer(BSerializer::SerializedSize(Value));
+    void* p = buffer.data();
+    BSerializer::Serialize(p, Value);
+    return buffer;
+}
+
+int main() {
+    RoundTrip(42);
+    RoundTrip(std::string("portable"));
+    RoundTrip(std::vector<bool>(131, true));
+    RoundTrip(std::vector<std::string>(100, std::string(40, 'x')));
+    RoundTrip(std::list<std::pair<int, double>>{ { 1, 2.5 }, { 3, 4.5 } });
+    RoundTrip(std::map<std::string, std::vector<int>>{ { "a", { 1, 2 } }, { "b", { } } });
+    RoundTrip(std::tuple<int, std::optional<std::string>, std::variant<int, std::string>>(7, "x", std::string("y")));
+
+    std::vector<uint8_t> buffer(256);
+    void* p = buffer.data();
+    std::istringstream words("3 1 4 1 5 9 2 6");
+    BSerializer::SerializeRange(p, buffer.data() + buffer.size(), std::views::istream<int>(words));
+    const void* q = buffer.data();
+    CHECK((BSerializer::Deserialize<std::vector<int>>(q) == std::vector<int>{ 3, 1, 4, 1, 5, 9, 2, 6 }));
+    CHECK(q == p);
+
+    auto evens = std::views::iota(0, 1000) | std::views::filter([](int i) { return i % 2 == 0; });
+    auto strings = std::views::iota(0, 100) | std::views::transform([](int i) { return std::string(i, 'z'); });
+    auto flags = std::views::iota(0, 200) | std::views::filter([](int i) { return i % 3 != 0; }) | std::views::transform([](int i) { return i % 5 == 0; });
+    auto overflows = [&buffer](size_t Size, auto&& Range) {
+        void* p = buffer.data();
+        try {
+            BSerializer::SerializeRange(p, buffer.data() + Size, Range);
+        }
+        catch (const std::out_of_range&) {
+            return p == buffer.data();
+        }
+        return false;
+    };
+    CHECK(overflows(256, evens));
+    CHECK(overflows(256, strings));
+    CHECK(overflows(4, std::vector<int>{ 1 }));
+    CHECK(overflows(16, flags));
+    CHECK(!overflows(BSerializer::SerializedRangeSize(flags), flags));
+    q = buffer.data();
+    std::vector<bool> expected;
+    for (bool f : flags) expected.push_back(f);
+    CHECK(BSerializer::Deserialize<std::vector<bool>>(q) == expected);
+
+    std::vector<std::string> names;
+    for (int i = 0; i < 50; ++i) names.push_back(std::string(i, (char)('a' + i % 26)));
+    std::vector<uint8_t> serialized = SerializeToBuffer(names);
+    q = serialized.data();
+    std::vector<std::string> visited;
+    BSerializer::ForEachSerialized<std::vector<std::string>>(q, [&visited](std::string&& Name) { visited.push_back(std::move(Name)); });
+    CHECK(visited == names);
+    CHECK(q == serialized.data() + serialized.size());
+
+    std::map<std::string, std::vector<int>> index{ { "a", { 1, 2 } }, { "b", { } }, { "c", { 3 } } };
+    serialized = SerializeToBuffer(index);
+    q = serialized.data();
+    std::map<std::string, std::vector<int>> entries;
+    BSerializer::ForEachSerialized<std::map<std::string, std::vector<int>>>(q, [&entries](std::string&& Key, std::vector<int>&& Value) { entries.emplace(std::move(Key), std::move(Value)); });
+    CHECK(entries == index);
+    CHECK(q == serialized.data() + serialized.size());
+    q = serialized.data();
+    entries.clear();
+    BSerializer::ForEachSerialized<std::map<std::string, std::vector<int>>>(q, [&entries](std::pair<const std::string, std::vector<int>>&& Entry) { entries.insert(std::move(Entry)); });
+    CHECK(entries == index);
+    CHECK(q == serialized.data() + serialized.size());
+
+    for (size_t n : { 0, 1, 63, 64, 65, 131 }) {
+        std::vector<bool> bits(n);
+        for (size_t i = 0; i < n; ++i) bits[i] = i % 3 == 0 || i % 7 == 0;
+        serialized = SerializeToBuffer(bits);
+        q = serialized.data();
+        std::vector<bool> visitedBits;
+        BSerializer::ForEachSerialized<std::vector<bool>>(q, [&visitedBits](bool Bit) { visitedBits.push_back(Bit); });
+        CHECK(visitedBits == bits);
+        CHECK(q == serialized.data() + serialized.size());
+    }
+
+    std::vector<int> numbers{ 3, 1, 4, 1, 5, 9, 2, 6 };
+    serialized = SerializeToBuffer(numbers);
+    q = serialized.data();
+    std::vector<int> appended{ 0 };
+    BSerializer::DeserializeTo<int>(q, std::back_inserter(appended));
+    CHECK((appended == std::vector<int>{ 0, 3, 1, 4, 1, 5, 9, 2, 6 }));
+    CHECK(q == serialized.data() + serialized.size());
+
+    serialized = SerializeToBuffer(names);
+    q = serialized.data();
+    std::vector<std::string> sized(names.size() + 1, "unwritten");
+    auto last = BSerializer::DeserializeTo<std::string>(q, sized.begin());
+    CHECK(last == sized.begin() + names.size());
+    CHECK(std::equal(names.begin(), names.end(), sized.begin()));
+    CHECK(sized.back() == "unwritten");
+    CHECK(q == serialized.data() + serialized.size());
+
+    std::vector<bool> bits(100);
+    for (size_t i = 0; i < bits.size(); i += 3) bits[i] = true;
+    serialized = SerializeToBuffer(bits);
+    q = serialized.data();
+    bool flagsOut[100];
+    CHECK(BSerializer::DeserializeTo<bool>(q, flagsOut) == flagsOut + 100);
+    CHECK(std::equal(bits.begin(), bits.end(), flagsOut));
+    CHECK(q == serialized.data() + serialized.size());
+
+    RoundTrip<std::endian::big>(0x0102030405060708ull);
+    RoundTrip<std::endian::big>(-2.5);
+    RoundTrip<std::endian::big>(std::string("portable"));
+    RoundTrip<std::endian::big>(std::vector<bool>(131, true));
+    RoundTrip<std::endian::big>(std::vector<short>{ 1, -2, 300, -400 });
+    RoundTrip<std::endian::big>(std::map<std::string, std::vector<int>>{ { "a", { 1, 2 } }, { "b", { } } });
+    RoundTrip<std::endian::big>(std::tuple<int, std::optional<std::string>, std::variant<int, std::string>>(7, "x", std::string("y")));
+    uint8_t word[4];
+    p = word;
+    BSerializer::Serialize<std::endian::big>(p, (uint32_t)0x01020304);
+    CHECK(word[0] == 1 && word[1] == 2 && word[2] == 3 && word[3] == 4);
+    p = word;
+    BSerializer::Serialize<std::endian::little>(p, (uint32_t)0x01020304);
+    CHECK(word[0] == 4 && word[1] == 3 && word[2] == 2 && word[3] == 1);
+
+    uint8_t header[BSerializer::WireHeaderSize];
+    p = header;
+    BSerializer::SerializeWireHeader<std::endian::big>(p);
+    CHECK(p == header + sizeof(header));
+    q = header;
+    CHECK(!BSerializer::CheckWireHeader<std::endian::little>(q));
+    CHECK(q == header);
+    CHECK(BSerializer::CheckWireHeader<std::endian::big>(q));
+    CHECK(q == header + sizeof(header));
+    p = header;
+    BSerializer::SerializeWireHeader<std::endian::little>(p);
+    q = header;
+    CHECK(!BSerializer::CheckWireHeader<std::endian::big>(q));
+    CHECK(BSerializer::CheckWireHeader<std::endian::little>(q));
+    header[5] = sizeof(size_t) == 8 ? 4 : 8;
+    q = header;
+    CHECK(!BSerializer::CheckWireHeader<std::endian::little>(q));
+    CHECK(q == header);
+    p = header;
+    BSerializer::SerializeWireHeader<std::endian::little>(p);
+    header[0] = 'X';
+    q = header;
+    CHECK(!BSerializer::CheckWireHeader<std::endian::little>(q));
+    CHECK(q == header);
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include <stdexcept>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "Check.h"
+#include "SharedRing.h"
+
+using Message = std::pair<int, std::string>;
+
+int main() {
+    const char* name = "/bserializer_ring_test";
+    BSerializer::SharedMemory::Unlink(name);
+    size_t capacity = 1 << 16;
+    BSerializer::SharedMemory memory(name, BSerializer::SharedRingSize(capacity));
+    BSerializer::InitializeSharedRing(memory.Data(), capacity);
+    const int count = 20000;
+    pid_t pid = fork();
+    CHECK(pid >= 0);
+    if (!pid) {
+        BSerializer::SharedMemory view(name, BSerializer::SharedRingSize(capacity));
+        BSerializer::SharedRingConsumer consumer(view.Data(), 8);
+        long long sum = 0;
+        for (int received = 0; received < count; ) {
+            alignas(Message) uint8_t storage[sizeof(Message)];
+            Message* m = (Message*)storage;
+            if (!consumer.Receive(m)) continue;
+            if ((int)m->second.size() != m->first % 37) _exit(2);
+            sum += m->first;
+            ++received;
+            m->~Message();
+        }
+        consumer.Publish();
+        _exit(sum == (long long)count * (count - 1) / 2 ? 0 : 1);
+    }
+    BSerializer::SharedRingProducer producer(memory.Data(), 4);
+    for (int i = 0; i < count; ++i) {
+        Message m(i, std::string(i % 37, 'x'));
+        while (!producer.Send(m)) producer.Publish();
+    }
+    producer.Publish();
+    int status;
+    CHECK(waitpid(pid, &status, 0) == pid);
+    BSerializer::SharedMemory::Unlink(name);
+    CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    alignas(64) static uint8_t small[1024];
+    CHECK(BSerializer::SharedRingSize(256) <= sizeof(small));
+    BSerializer::InitializeSharedRing(small, 256);
+    BSerializer::SharedRingProducer bounded(small);
+    BSerializer::SharedRingConsumer drain(small);
+    CHECK(bounded.MaxMessageSize() == 120);
+    bool threw = false;
+    try {
+        bounded.Send(std::string(300, 'x'));
+    }
+    catch (const std::length_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+    for (size_t size : { 16, 120, 40, 120, 120, 8, 120 }) {
+        CHECK(bounded.Reserve(size));
+        bounded.Commit();
+        size_t peeked;
+        CHECK(drain.Peek(peeked) && peeked == size);
+        drain.Release();
+    }
+    CHECK(bounded.Reserve(120));
+    bounded.Commit();
+    CHECK(!bounded.Reserve(120));
+    return 0;
+}
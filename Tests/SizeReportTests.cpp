@@ -0,0 +1,74 @@
+#include <array>
+#include <map>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <variant>
+#include <vector>
+#include "Check.h"
+#include "SizeReport.h"
+
+// Where a node has children, its bytes are its own overhead plus those of its children.
+static void CheckConsistent(const BSerializer::SizeReportNode& Node) {
+    if (Node.children.empty()) return;
+    size_t bytes = Node.overhead;
+    for (const BSerializer::SizeReportNode& c : Node.children) {
+        bytes += c.bytes;
+        CheckConsistent(c);
+    }
+    CHECK(bytes == Node.bytes);
+}
+
+template <typename _T>
+static BSerializer::SizeReportNode CheckReport(const _T& Value) {
+    BSerializer::SizeReportNode n = BSerializer::SizeReport(Value);
+    CHECK(n.bytes == BSerializer::SerializedSize(Value));
+    CHECK(n.type == BSerializer::TypeName<_T>());
+    CHECK(n.label.empty() && n.instances == 1);
+    CheckConsistent(n);
+    return n;
+}
+
+using Variant = std::variant<std::monostate, int, std::string, std::vector<double>>;
+
+int main() {
+    CheckReport(42);
+    CheckReport(std::string("report"));
+    CheckReport(std::vector<bool>(131, true));
+    CheckReport(std::pair<int, std::string>(1, "first"));
+    CheckReport(std::tuple<char, std::optional<int>, std::optional<std::string>>('t', 5, std::nullopt));
+    for (const Variant& v : { Variant(), Variant(7), Variant(std::string("alternative")), Variant(std::vector<double>(9, 1.0)) }) CheckReport(v);
+    CheckReport(std::array<std::string, 3>{ "a", "bb", "" });
+    CheckReport(std::map<std::string, std::vector<std::optional<Variant>>>{ { "x", { std::nullopt, Variant(3) } }, { "yy", { } }, { "zzz", { Variant(std::string("s")) } } });
+
+    BSerializer::SizeReportNode optional = CheckReport(std::optional<std::vector<int>>(std::vector<int>(10, 1)));
+    CHECK(optional.overhead == sizeof(bool));
+    CHECK(optional.children.size() == 1 && optional.children[0].label == "value");
+    CHECK(optional.children[0].overhead == sizeof(size_t));
+    CHECK(optional.children[0].children[0].label == "[]" && optional.children[0].children[0].instances == 10);
+
+    std::vector<std::pair<int, std::string>> pairs{ { 1, "a" }, { 2, "bcd" }, { 3, "" } };
+    BSerializer::SizeReportNode collection = CheckReport(pairs);
+    CHECK(collection.children.size() == 1);
+    const BSerializer::SizeReportNode& elements = collection.children[0];
+    CHECK(elements.instances == 3 && elements.children.size() == 2);
+    CHECK(elements.children[0].label == "first" && elements.children[0].bytes == 3 * sizeof(int));
+    CHECK(elements.children[1].label == "second" && elements.children[1].overhead == 3 * sizeof(size_t));
+
+    BSerializer::SizeReportCorpus corpus;
+    size_t total = 0;
+    for (const Variant& v : { Variant(7), Variant(std::string("abc")), Variant(8) }) {
+        corpus.Add(v);
+        total += BSerializer::SerializedSize(v);
+    }
+    corpus.Add(std::string("other"));
+    CHECK(corpus.Roots().size() == 2);
+    CHECK(corpus.Roots()[0].instances == 3 && corpus.Roots()[0].bytes == total);
+    CheckConsistent(corpus.Roots()[0]);
+    std::vector<BSerializer::SizeReportTypeTotal> totals = corpus.ByType();
+    for (size_t i = 1; i < totals.size(); ++i) CHECK(totals[i - 1].bytes >= totals[i].bytes);
+    CHECK(totals[0].type == BSerializer::TypeName<Variant>() && totals[0].instances == 3 && totals[0].overhead == 3 * sizeof(size_t));
+    CHECK(corpus.Dump().find(std::string(BSerializer::TypeName<Variant>()) + ": " + std::to_string(total) + " bytes, " + std::to_string(3 * sizeof(size_t)) + " overhead, 3 instances\n") == 0);
+    return 0;
+}
@@ -0,0 +1,21 @@
+#include "Check.h"
+#include "StreamingBenchmark.h"
+
+int main() {
+    std::vector<BSerializer::StreamingBenchmarkResult> results = BSerializer::BenchmarkStreamingThreshold(64 << 10, 4 << 10, 48 << 10, 2);
+    CHECK(results.size() == 5);
+    CHECK(results.front().bytes == (4 << 10) && results.back().bytes == (48 << 10));
+    for (const BSerializer::StreamingBenchmarkResult& r : results) CHECK(r.cachedBytesPerSecond > 0 && r.streamingBytesPerSecond > 0);
+
+    std::vector<BSerializer::StreamingBenchmarkResult> synthetic = {
+        { 1 << 20, 4e9, 2e9, 1000, 1000 },
+        { 2 << 20, 4e9, 3e9, 1000, 1000 },
+        { 4 << 20, 4e9, 5e9, 1000, 1000 },
+        { 8 << 20, 4e9, 3.9e9, 1000, 1000 },
+        { 16 << 20, 4e9, 5e9, 1000, 1000 }
+    };
+    CHECK(BSerializer::SuggestStreamingThreshold(synthetic) == (4 << 20));
+    synthetic[2].streamingBytesPerSecond = synthetic[4].streamingBytesPerSecond = 3e9;
+    CHECK(BSerializer::SuggestStreamingThreshold(synthetic) == SIZE_MAX);
+    return 0;
+}
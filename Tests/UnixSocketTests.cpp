@@ -0,0 +1,85 @@
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Check.h"
+#include "UnixSocket.h"
+
+using Message = std::pair<uint32_t, std::vector<double>>;
+
+int main() {
+    auto [a, b] = BSerializer::UnixSocket::Pair();
+    const int count = 5000;
+    std::thread sender([&] {
+        BSerializer::UnixMessageSender s(a.Handle(), 32, 64);
+        std::vector<Message> live;
+        for (int i = 0; i < count; ++i) {
+            live.emplace_back((uint32_t)i, std::vector<double>(i % 300, i * 0.5));
+            s.Send(live.back());
+            if (live.size() == 32) live.clear();
+        }
+        s.Flush();
+        a = BSerializer::UnixSocket();
+    });
+    BSerializer::UnixMessageReceiver receiver(b.Handle(), 1000);
+    int received = 0;
+    while (receiver.ReceiveBatch<Message>([&](Message&& m) {
+        CHECK((int)m.first == received);
+        CHECK(m.second.size() == (size_t)(received % 300));
+        CHECK(m.second.empty() || m.second[0] == received * 0.5);
+        ++received;
+    })) { }
+    sender.join();
+    CHECK(received == count);
+
+    {
+        auto [c, d] = BSerializer::UnixSocket::Pair();
+        BSerializer::UnixMessageSender s(c.Handle());
+        for (size_t i = 0; i < 20; ++i) s.Send(std::string(i, 'y'));
+        s.Flush();
+        BSerializer::UnixMessageReceiver r(d.Handle());
+        for (size_t i = 0; i < 20; ++i) {
+            size_t size;
+            const void* p;
+            while (!(p = r.Peek(size))) CHECK(r.Fill());
+            CHECK((uintptr_t)p % 8 == 0);
+            CHECK(size == sizeof(size_t) + i);
+            CHECK((BSerializer::Deserialize<std::endian::native, std::string>(p) == std::string(i, 'y')));
+            r.Release();
+        }
+    }
+
+    for (uint64_t size : { (uint64_t)1025, UINT64_MAX - 3 }) {
+        auto [c, d] = BSerializer::UnixSocket::Pair();
+        CHECK(write(c.Handle(), &size, sizeof(size)) == (ssize_t)sizeof(size));
+        BSerializer::UnixMessageReceiver r(d.Handle(), 64, 1024);
+        bool threw = false;
+        try {
+            alignas(std::string) uint8_t storage[sizeof(std::string)];
+            r.Receive((std::string*)storage);
+        }
+        catch (const std::length_error&) {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+
+    std::string path = (std::filesystem::temp_directory_path() / "bserializer_socket_test").string();
+    unlink(path.c_str());
+    BSerializer::UnixSocket listener = BSerializer::UnixSocket::Listen(path.c_str());
+    std::thread client([&] {
+        BSerializer::UnixSocket s = BSerializer::UnixSocket::Connect(path.c_str());
+        BSerializer::UnixMessageSender snd(s.Handle());
+        snd.Send(std::string("hello"));
+        snd.Flush();
+    });
+    BSerializer::UnixSocket accepted = listener.Accept();
+    BSerializer::UnixMessageReceiver r(accepted.Handle());
+    alignas(std::string) uint8_t storage[sizeof(std::string)];
+    CHECK(r.Receive((std::string*)storage));
+    CHECK(*(std::string*)storage == "hello");
+    ((std::string*)storage)->~basic_string();
+    client.join();
+    unlink(path.c_str());
+    return 0;
+}
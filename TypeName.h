@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include "Platform.h"
+
+namespace BSerializer {
+    namespace details {
+        template <typename _T>
+        constexpr std::string_view typeNameView();
+
+        constexpr uint64_t fnv1a(std::string_view Text);
+
+        template <typename _T>
+        struct typeNameStorage final {
+            static constexpr std::string_view view = typeNameView<_T>();
+            static constexpr std::array<char, view.size() + 1> value = [] {
+                std::array<char, view.size() + 1> a{ };
+                for (size_t i = 0; i < view.size(); ++i) a[i] = view[i];
+                return a;
+            }();
+        };
+    }
+
+    /**
+     * @brief Returns the name of a type, as spelled by the compiler.
+     * @tparam _T The type.
+     * @return A null-terminated string with static storage duration.
+     */
+    template <typename _T>
+    constexpr const char* TypeName();
+    /**
+     * @brief Returns a 64-bit FNV-1a hash of the name of a type, which identifies the type in trace probes and reports.
+     * @tparam _T The type.
+     * @return The hash of BSerializer::TypeName<_T>(). It is stable across runs of the same build, but not across compilers.
+     */
+    template <typename _T>
+    constexpr uint64_t TypeHash();
+}
+
+template <typename _T>
+constexpr std::string_view BSerializer::details::typeNameView() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    std::string_view s = __FUNCSIG__;
+    size_t b = s.find("typeNameView<") + 13;
+    return s.substr(b, s.rfind(">(void)") - b);
+#else
+    std::string_view s = __PRETTY_FUNCTION__;
+    size_t b = s.find("_T = ") + 5;
+    return s.substr(b, s.find_first_of(";]", b) - b);
+#endif
+}
+
+constexpr uint64_t BSerializer::details::fnv1a(std::string_view Text) {
+    uint64_t h = 14695981039346656037ull;
+    for (char c : Text) {
+        h ^= (uint8_t)c;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+template <typename _T>
+constexpr const char* BSerializer::TypeName() {
+    return details::typeNameStorage<_T>::value.data();
+}
+
+template <typename _T>
+constexpr uint64_t BSerializer::TypeHash() {
+    return details::fnv1a(details::typeNameStorage<_T>::view);
+}
@@ -0,0 +1,397 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include "GatherSerializer.h"
+#include "Serializer.h"
+
+#if __has_include(<sys/un.h>)
+#include <cerrno>
+#include <climits>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace BSerializer {
+    namespace details {
+        constexpr size_t unixFrameHeaderSize = sizeof(uint64_t);
+
+        constexpr uint8_t unixFramePadding[8] = { };
+
+        __forceinline uint64_t unixFrameSize(uint64_t Size);
+
+#ifdef MSG_NOSIGNAL
+        constexpr int unixSendFlags = MSG_NOSIGNAL;
+#else
+        constexpr int unixSendFlags = 0;
+#endif
+    }
+
+    /**
+     * @brief An owned connected or listening `AF_UNIX` stream socket. The socket is closed when the object is destroyed.
+     */
+    class UnixSocket final {
+    public:
+        /**
+         * @brief Creates an object that owns no socket.
+         */
+        __forceinline UnixSocket();
+        /**
+         * @brief Takes ownership of an existing socket descriptor.
+         * @param[in] Handle The socket descriptor.
+         */
+        __forceinline explicit UnixSocket(int Handle);
+        __forceinline UnixSocket(UnixSocket&& Other);
+        __forceinline UnixSocket& operator=(UnixSocket&& Other);
+        UnixSocket(const UnixSocket&) = delete;
+        UnixSocket& operator=(const UnixSocket&) = delete;
+        inline ~UnixSocket();
+
+        /**
+         * @brief Creates a pair of connected sockets with `socketpair`, so that both ends can live in one process.
+         * @return The two ends of the connection.
+         */
+        static inline std::pair<UnixSocket, UnixSocket> Pair();
+        /**
+         * @brief Connects to a socket listening at a filesystem path.
+         * @param[in] Path The path of the listening socket.
+         * @return The connected socket.
+         */
+        static inline UnixSocket Connect(const char* Path);
+        /**
+         * @brief Creates a socket listening at a filesystem path. The path must not already exist.
+         * @param[in] Path The path at which to listen.
+         * @param[in] Backlog The maximum quantity of pending connections.
+         * @return The listening socket.
+         */
+        static inline UnixSocket Listen(const char* Path, int Backlog = 16);
+        /**
+         * @brief Accepts a connection on a listening socket, blocking until one arrives.
+         * @return The connected socket.
+         */
+        inline UnixSocket Accept() const;
+
+        /**
+         * @brief Returns the socket descriptor.
+         * @return The socket descriptor, or -1 if the object owns no socket.
+         */
+        __forceinline int Handle() const;
+    private:
+        int handle;
+    };
+
+    /**
+     * @brief Sends length-prefixed serialized messages over a stream socket, batching several messages into each `sendmsg` call.
+     *
+     * Each message is framed as its size in bytes, as a native-endian `uint64_t`, followed by the message serialized in the architecture's byte order, since both ends share a host, and zero padding up to a multiple of 8 bytes. Every message therefore starts 8-byte aligned in the receive buffer, as records do in BSerializer::SharedRingProducer.
+     * Messages are gathered with a BSerializer::GatherSerializer, so contiguous arithmetic data at or above the reference threshold is sent straight from the source value. Such values must remain unmodified until the next flush.
+     *
+     * Example:
+     * @code
+     * auto [a, b] = BSerializer::UnixSocket::Pair();
+     * BSerializer::UnixMessageSender sender(a.Handle());
+     * for (const Record& r : records) sender.Send(r);
+     * sender.Flush();
+     * @endcode
+     */
+    class UnixMessageSender final {
+    public:
+        /**
+         * @brief Attaches to a connected stream socket.
+         * @param[in] Handle The socket descriptor. The sender does not take ownership of it.
+         * @param[in] BatchSize The quantity of messages after which the batch is flushed automatically.
+         * @param[in] ReferenceThreshold The minimum size, in bytes, of an arithmetic range for it to be sent by reference rather than copied.
+         */
+        inline UnixMessageSender(int Handle, size_t BatchSize = 64, size_t ReferenceThreshold = 1024);
+        UnixMessageSender(const UnixMessageSender&) = delete;
+        UnixMessageSender& operator=(const UnixMessageSender&) = delete;
+
+        /**
+         * @brief Appends a message to the current batch, flushing the batch once it holds BatchSize messages.
+         * @tparam _T The type of the value sent. _T must conform to BSerializer::Serializable.
+         * @param[in] Value The value to send.
+         */
+        template <Serializable _T>
+        __forceinline void Send(const _T& Value);
+        /**
+         * @brief Writes every message in the current batch to the socket, blocking until all of them have been accepted.
+         */
+        inline void Flush();
+        /**
+         * @brief Returns the quantity of messages in the current batch.
+         * @return The quantity of messages that have not yet been flushed.
+         */
+        __forceinline size_t Pending() const;
+    private:
+        int handle;
+        size_t batchSize;
+        size_t pending;
+        GatherSerializer gather;
+    };
+
+    /**
+     * @brief Receives length-prefixed serialized messages written by BSerializer::UnixMessageSender.
+     *
+     * Each read from the socket takes as many bytes as fit in the receive buffer, which typically holds many messages, and messages are deserialized straight from the buffer. The buffer grows to fit a message larger than itself, up to the maximum message size; a larger frame is rejected before anything is allocated for it.
+     */
+    class UnixMessageReceiver final {
+    public:
+        /**
+         * @brief Attaches to a connected stream socket.
+         * @param[in] Handle The socket descriptor. The receiver does not take ownership of it.
+         * @param[in] BufferSize The initial size of the receive buffer, in bytes.
+         * @param[in] MaxMessageSize The size of the largest message accepted from the peer, in bytes.
+         */
+        inline UnixMessageReceiver(int Handle, size_t BufferSize = 65536, size_t MaxMessageSize = 64 << 20);
+        UnixMessageReceiver(const UnixMessageReceiver&) = delete;
+        UnixMessageReceiver& operator=(const UnixMessageReceiver&) = delete;
+
+        /**
+         * @brief Reads from the socket once, blocking until data is available.
+         * @return Whether any data was read. If not, the peer has closed the connection.
+         * @exception std::length_error Thrown if the next frame is larger than the maximum message size. The stream cannot be resynchronized, and the connection should be closed.
+         */
+        inline bool Fill();
+        /**
+         * @brief Returns the next complete message in the receive buffer without consuming it. The socket is not read.
+         * @param[out] Size The size of the message, in bytes.
+         * @return A pointer to the message, or null if the buffer does not hold a complete message.
+         * @exception std::length_error Thrown if the next frame is larger than the maximum message size. The stream cannot be resynchronized, and the connection should be closed.
+         */
+        inline const void* Peek(size_t& Size);
+        /**
+         * @brief Consumes the message returned by the last call to Peek. The message must not be accessed afterwards.
+         */
+        __forceinline void Release();
+        /**
+         * @brief Deserializes the next message, reading from the socket as needed.
+         * @tparam _T The type of the value deserialized. _T must conform to BSerializer::Serializable.
+         * @param[out] Value A pointer to the location in memory in which the deserialized value will be placed.
+         * @return Whether a message was received. If not, the peer has closed the connection and nothing is written to Value.
+         * @exception std::length_error Thrown if the next frame is larger than the maximum message size.
+         */
+        template <Serializable _T>
+        __forceinline bool Receive(_T* Value);
+        /**
+         * @brief Deserializes every complete message in the receive buffer, passing each to a callback. If the buffer holds no complete message, the socket is read until it does.
+         * @tparam _T The type of the values deserialized. _T must conform to BSerializer::Serializable.
+         * @tparam _TFunc The type of the callback.
+         * @param[in] Callback The callback invoked with each deserialized value, in the order sent.
+         * @return The quantity of messages passed to the callback. Zero indicates that the peer has closed the connection.
+         * @exception std::length_error Thrown if the next frame is larger than the maximum message size.
+         */
+        template <Serializable _T, typename _TFunc>
+        __forceinline size_t ReceiveBatch(_TFunc&& Callback);
+    private:
+        int handle;
+        std::unique_ptr<uint8_t[]> buffer;
+        size_t capacity;
+        size_t begin;
+        size_t end;
+        size_t peeked;
+        size_t maxMessageSize;
+
+        inline size_t FrameSize(uint64_t Size) const;
+    };
+}
+
+__forceinline BSerializer::UnixSocket::UnixSocket()
+    : handle(-1) { }
+
+__forceinline BSerializer::UnixSocket::UnixSocket(int Handle)
+    : handle(Handle) { }
+
+__forceinline BSerializer::UnixSocket::UnixSocket(UnixSocket&& Other)
+    : handle(std::exchange(Other.handle, -1)) { }
+
+__forceinline BSerializer::UnixSocket& BSerializer::UnixSocket::operator=(UnixSocket&& Other) {
+    if (this != &Other) {
+        if (handle >= 0) close(handle);
+        handle = std::exchange(Other.handle, -1);
+    }
+    return *this;
+}
+
+inline BSerializer::UnixSocket::~UnixSocket() {
+    if (handle >= 0) close(handle);
+}
+
+inline std::pair<BSerializer::UnixSocket, BSerializer::UnixSocket> BSerializer::UnixSocket::Pair() {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds)) throw std::system_error(errno, std::system_category(), "socketpair");
+    return { UnixSocket(fds[0]), UnixSocket(fds[1]) };
+}
+
+inline BSerializer::UnixSocket BSerializer::UnixSocket::Connect(const char* Path) {
+    sockaddr_un addr = { };
+    addr.sun_family = AF_UNIX;
+    size_t len = strlen(Path);
+    if (len >= sizeof(addr.sun_path)) throw std::invalid_argument("'Path' is too long for a Unix domain socket address.");
+    memcpy(addr.sun_path, Path, len);
+    UnixSocket s(socket(AF_UNIX, SOCK_STREAM, 0));
+    if (s.handle < 0) throw std::system_error(errno, std::system_category(), "socket");
+    if (connect(s.handle, (const sockaddr*)&addr, sizeof(addr))) throw std::system_error(errno, std::system_category(), "connect");
+    return s;
+}
+
+inline BSerializer::UnixSocket BSerializer::UnixSocket::Listen(const char* Path, int Backlog) {
+    sockaddr_un addr = { };
+    addr.sun_family = AF_UNIX;
+    size_t len = strlen(Path);
+    if (len >= sizeof(addr.sun_path)) throw std::invalid_argument("'Path' is too long for a Unix domain socket address.");
+    memcpy(addr.sun_path, Path, len);
+    UnixSocket s(socket(AF_UNIX, SOCK_STREAM, 0));
+    if (s.handle < 0) throw std::system_error(errno, std::system_category(), "socket");
+    if (bind(s.handle, (const sockaddr*)&addr, sizeof(addr))) throw std::system_error(errno, std::system_category(), "bind");
+    if (listen(s.handle, Backlog)) throw std::system_error(errno, std::system_category(), "listen");
+    return s;
+}
+
+inline BSerializer::UnixSocket BSerializer::UnixSocket::Accept() const {
+    int fd;
+    do fd = accept(handle, 0, 0);
+    while (fd < 0 && errno == EINTR);
+    if (fd < 0) throw std::system_error(errno, std::system_category(), "accept");
+    return UnixSocket(fd);
+}
+
+__forceinline int BSerializer::UnixSocket::Handle() const {
+    return handle;
+}
+
+__forceinline uint64_t BSerializer::details::unixFrameSize(uint64_t Size) {
+    return unixFrameHeaderSize + ((Size + 7) & ~(uint64_t)7);
+}
+
+inline BSerializer::UnixMessageSender::UnixMessageSender(int Handle, size_t BatchSize, size_t ReferenceThreshold)
+    : handle(Handle), batchSize(BatchSize ? BatchSize : 1), pending(0), gather(ReferenceThreshold) { }
+
+template <BSerializer::Serializable _T>
+__forceinline void BSerializer::UnixMessageSender::Send(const _T& Value) {
+    size_t size = SerializedSize(Value);
+    gather.Serialize<std::endian::native>((uint64_t)size);
+    gather.Serialize<std::endian::native>(Value);
+    gather.SerializeRaw(details::unixFramePadding, (size_t)(0 - size) & 7);
+    if (++pending >= batchSize) Flush();
+}
+
+inline void BSerializer::UnixMessageSender::Flush() {
+    GatherSegment* segments = gather.Segments();
+    size_t count = gather.SegmentCount();
+    while (count) {
+        msghdr msg = { };
+        msg.msg_iov = segments;
+        msg.msg_iovlen = count < IOV_MAX ? count : IOV_MAX;
+        ssize_t n = sendmsg(handle, &msg, details::unixSendFlags);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw std::system_error(errno, std::system_category(), "sendmsg");
+        }
+        size_t s = (size_t)n;
+        while (count && s >= segments->iov_len) {
+            s -= segments->iov_len;
+            ++segments;
+            --count;
+        }
+        if (s) {
+            segments->iov_base = (uint8_t*)segments->iov_base + s;
+            segments->iov_len -= s;
+        }
+    }
+    gather.Clear();
+    pending = 0;
+}
+
+__forceinline size_t BSerializer::UnixMessageSender::Pending() const {
+    return pending;
+}
+
+inline BSerializer::UnixMessageReceiver::UnixMessageReceiver(int Handle, size_t BufferSize, size_t MaxMessageSize)
+    : handle(Handle), capacity(std::max(BufferSize, details::unixFrameHeaderSize)), begin(0), end(0), peeked(0), maxMessageSize(MaxMessageSize) {
+    buffer.reset(new uint8_t[capacity]);
+}
+
+inline bool BSerializer::UnixMessageReceiver::Fill() {
+    if (begin) {
+        memmove(buffer.get(), buffer.get() + begin, end - begin);
+        end -= begin;
+        begin = 0;
+    }
+    if (end >= details::unixFrameHeaderSize) {
+        uint64_t s;
+        memcpy(&s, buffer.get(), sizeof(uint64_t));
+        size_t need = FrameSize(s);
+        if (need > capacity) {
+            std::unique_ptr<uint8_t[]> b(new uint8_t[need]);
+            memcpy(b.get(), buffer.get(), end);
+            buffer = std::move(b);
+            capacity = need;
+        }
+    }
+    ssize_t n;
+    do n = recv(handle, buffer.get() + end, capacity - end, 0);
+    while (n < 0 && errno == EINTR);
+    if (n < 0) throw std::system_error(errno, std::system_category(), "recv");
+    end += (size_t)n;
+    return n > 0;
+}
+
+inline const void* BSerializer::UnixMessageReceiver::Peek(size_t& Size) {
+    size_t available = end - begin;
+    if (available < details::unixFrameHeaderSize) return 0;
+    uint64_t s;
+    memcpy(&s, buffer.get() + begin, sizeof(uint64_t));
+    size_t frame = FrameSize(s);
+    if (available < frame) return 0;
+    Size = (size_t)s;
+    peeked = frame;
+    return buffer.get() + begin + details::unixFrameHeaderSize;
+}
+
+inline size_t BSerializer::UnixMessageReceiver::FrameSize(uint64_t Size) const {
+    if (Size > maxMessageSize || Size > SIZE_MAX - details::unixFrameHeaderSize - 7) throw std::length_error("The peer sent a message larger than the maximum message size.");
+    return (size_t)details::unixFrameSize(Size);
+}
+
+__forceinline void BSerializer::UnixMessageReceiver::Release() {
+    begin += peeked;
+    peeked = 0;
+    if (begin == end) begin = end = 0;
+}
+
+template <BSerializer::Serializable _T>
+__forceinline bool BSerializer::UnixMessageReceiver::Receive(_T* Value) {
+    size_t size;
+    const void* p;
+    while (!(p = Peek(size))) {
+        if (!Fill()) return false;
+    }
+    BSerializer::Deserialize<std::endian::native>(p, Value);
+    Release();
+    return true;
+}
+
+template <BSerializer::Serializable _T, typename _TFunc>
+__forceinline size_t BSerializer::UnixMessageReceiver::ReceiveBatch(_TFunc&& Callback) {
+    size_t size;
+    size_t count = 0;
+    while (!Peek(size)) {
+        if (!Fill()) return 0;
+    }
+    while (const void* p = Peek(size)) {
+        alignas(_T) uint8_t bytes[sizeof(_T)];
+        _T* p_v = (_T*)bytes;
+        BSerializer::Deserialize<std::endian::native>(p, p_v);
+        Release();
+        _T v(std::move(*p_v));
+        p_v->~_T();
+        Callback(std::move(v));
+        ++count;
+    }
+    return count;
+}
+#endif